@@ -0,0 +1,207 @@
+# MAX2870 sweep/channel table generator by Bryce Cherry
+# Generates a header with a flash resident (PROGMEM) table for WriteCompactSweepValues_P()/WriteSweepValues_P() with the same registers as setf() in channel step mode
+# Usage: python MAX2870table.py --ref reference_frequency_in_Hz --r R_divider --refmode UNDIVIDED/HALF/DOUBLE --step channel_step_in_Hz (--frequencies file_with_one_frequency_in_Hz_per_line | --start start_frequency_in_Hz --stop stop_frequency_in_Hz --increment increment_in_Hz) --name table_name --output header_file [--format COMPACT/FULL] [--power 0-4] [--auxpower 0-4] [--auxmode DIVIDED/FUNDAMENTAL]
+# COMPACT tables (default) only hold R0 and MOD/RF divider select for each step - call setf() with the first frequency beforehand to set the remaining registers
+# FULL tables hold all six registers as they would be after setrf()/setf() from the power on defaults of the library - changes from setCPcurrent()/setPDpolarity() etc. are not included
+
+import argparse
+import math
+import sys
+
+# MAX2870 limits as per datasheet
+MaximumMod = 4095
+MinimumRFFrequency = 23437500
+MaximumRFFrequency = 6000000000
+MaximumPFDFrequencyFractional = 50000000
+
+PowerOnRegisters = [0x007D0000, 0x2000FFF9, 0x18006E42, 0x0000000B, 0x6180B23C, 0x00400005] # as per MAX2870_R[] in MAX2870.h
+
+def WriteField(register, offset, width, value):
+  mask = ((1 << width) - 1) << offset
+  return (register & ~mask) | ((value << offset) & mask)
+
+def RoundedFrequencyError(Numerator, Divisor):
+  # rounded to the nearest Hz with halves away from 0 as per RoundedFrequencyError() in MAX2870Device.h
+  Error = ((abs(Numerator) * 2) + Divisor) // (Divisor * 2)
+  if Numerator < 0:
+    Error = -Error
+  return Error
+
+def ClosestFraction(Remainder, PFDnumerator):
+  # closest FRAC/MOD with MOD <= 4095 as per ClosestFraction() in MAX2870Device.h
+  LowFrac, LowMod, HighFrac, HighMod = 0, 1, 1, 1
+  while (Remainder * LowMod) != (LowFrac * PFDnumerator):
+    MediantFrac = LowFrac + HighFrac
+    MediantMod = LowMod + HighMod
+    if MediantMod > MaximumMod:
+      break
+    MediantLeft = MediantFrac * PFDnumerator
+    MediantRight = Remainder * MediantMod
+    if MediantLeft == MediantRight:
+      return MediantFrac, MediantMod
+    if MediantLeft < MediantRight:
+      Steps = ((Remainder * LowMod) - (LowFrac * PFDnumerator)) // ((HighFrac * PFDnumerator) - (Remainder * HighMod))
+      Steps = min(Steps, (MaximumMod - LowMod) // HighMod)
+      LowFrac += Steps * HighFrac
+      LowMod += Steps * HighMod
+    else:
+      Steps = ((HighFrac * PFDnumerator) - (Remainder * HighMod)) // ((Remainder * LowMod) - (LowFrac * PFDnumerator))
+      Steps = min(Steps, (MaximumMod - HighMod) // LowMod)
+      HighFrac += Steps * LowFrac
+      HighMod += Steps * LowMod
+  Frac, Mod = LowFrac, LowMod
+  if HighFrac != HighMod:
+    LowError = ((Remainder * LowMod) - (LowFrac * PFDnumerator)) * HighMod
+    HighError = ((HighFrac * PFDnumerator) - (Remainder * HighMod)) * LowMod
+    if HighError < LowError:
+      Frac, Mod = HighFrac, HighMod
+  return Frac, Mod
+
+def CalculateChannel(Frequency, Reference, R, RefMode, Step):
+  # returns (INT, MOD, FRAC, RF divider select, frequency error in Hz) as per setf() in channel step mode
+  if (Reference // R) % Step != 0 and Step > 1:
+    sys.exit("PFD and step frequency division has remainder")
+  if Frequency > MaximumRFFrequency or Frequency < MinimumRFFrequency:
+    sys.exit("RF frequency is out of range: " + str(Frequency))
+  if Step > 1 and Frequency % Step != 0:
+    sys.exit("RF frequency and step frequency division has remainder: " + str(Frequency))
+  RfDivSel = 0
+  if Frequency > MinimumRFFrequency:
+    Ratio = 3000000000 // Frequency
+    while (1 << RfDivSel) <= Ratio and (1 << RfDivSel) <= 64:
+      RfDivSel += 1
+  else:
+    RfDivSel = 7
+  Divider = 1 << RfDivSel
+  PFDnumerator = Reference * (2 if RefMode == "DOUBLE" else 1)
+  PFDdenominator = R * (2 if RefMode == "HALF" else 1)
+  VCOnumerator = Frequency * Divider * PFDdenominator
+  N = VCOnumerator // PFDnumerator
+  Remainder = VCOnumerator % PFDnumerator
+  StepDenominator = Step * PFDdenominator
+  Mod = PFDnumerator // StepDenominator
+  Frac = ((Remainder * Divider * 2) + StepDenominator) // (StepDenominator * Divider * 2)
+  Factor = math.gcd(Mod, Frac)
+  if Factor != 0:
+    Mod //= Factor
+    Frac //= Factor
+  if Mod > MaximumMod:
+    if Frac >= Mod:
+      Frac = Mod - 1
+    TempFrac, TempMod = ClosestFraction(Frac, Mod)
+    if (Mod - Frac) * TempMod < abs((Frac * TempMod) - (Mod * TempFrac)):
+      N += 1
+      TempFrac, TempMod = 0, 2
+    Frac, Mod = TempFrac, TempMod
+  ErrorNumerator = (PFDnumerator * Frac) - ((VCOnumerator - (N * PFDnumerator)) * Mod)
+  ErrorDivisor = Divider * PFDdenominator * Mod
+  FrequencyError = RoundedFrequencyError(ErrorNumerator, ErrorDivisor)
+  if Frac == 0:
+    Mod = 2
+  if Mod < 2 or Mod > MaximumMod:
+    sys.exit("MOD is out of range: " + str(Frequency))
+  if Frac == 0 and (N < 16 or N > 65535):
+    sys.exit("N is out of range under integer mode: " + str(Frequency))
+  if Frac != 0 and (N < 19 or N > 4091):
+    sys.exit("N is out of range under fractional mode: " + str(Frequency))
+  if Frac != 0 and (PFDnumerator // PFDdenominator) > MaximumPFDFrequencyFractional:
+    sys.exit("PFD exceeded with fractional mode: " + str(Frequency))
+  return N, Mod, Frac, RfDivSel, FrequencyError
+
+def PackRegisters(Registers, N, Mod, Frac, RfDivSel):
+  # as per PackFrequency() in MAX2870Device.h
+  Registers = list(Registers)
+  Fractional = 1 if Frac != 0 else 0
+  Registers[0] = WriteField(Registers[0], 3, 12, Frac)
+  Registers[0] = WriteField(Registers[0], 15, 16, N)
+  Registers[0] = WriteField(Registers[0], 31, 1, 1 - Fractional)
+  Registers[1] = WriteField(Registers[1], 29, 2, Fractional)
+  Registers[1] = WriteField(Registers[1], 31, 1, 1 - Fractional)
+  Registers[2] = WriteField(Registers[2], 8, 1, 1 - Fractional)
+  Registers[5] = WriteField(Registers[5], 24, 1, 1 - Fractional)
+  Registers[1] = WriteField(Registers[1], 3, 12, Mod)
+  Registers[4] = WriteField(Registers[4], 20, 3, RfDivSel)
+  return Registers
+
+def TemplateRegisters(Reference, R, RefMode, Power, AuxPower, AuxMode):
+  # registers after setrf() and setf() other than the frequency fields
+  Registers = list(PowerOnRegisters)
+  Registers[2] = WriteField(Registers[2], 14, 10, R)
+  Registers[2] = WriteField(Registers[2], 24, 2, {"UNDIVIDED": 0, "HALF": 1, "DOUBLE": 2}[RefMode])
+  PFDFrequency = (Reference * (2 if RefMode == "DOUBLE" else 1)) // (R * (2 if RefMode == "HALF" else 1))
+  Registers[2] = WriteField(Registers[2], 31, 1, 1 if PFDFrequency > 32000000 else 0) # lock detect speed
+  BandSelectDivider = min(-(-(Reference * (2 if RefMode == "DOUBLE" else 1)) // (R * (2 if RefMode == "HALF" else 1) * 50000)), 1023) # band select clock of no more than 50 kHz
+  Registers[4] = WriteField(Registers[4], 12, 8, BandSelectDivider & 0xFF)
+  Registers[4] = WriteField(Registers[4], 24, 2, BandSelectDivider >> 8)
+  if Power == 0:
+    Registers[4] = WriteField(Registers[4], 5, 1, 0)
+  else:
+    Registers[4] = WriteField(Registers[4], 5, 1, 1)
+    Registers[4] = WriteField(Registers[4], 3, 2, Power - 1)
+  if AuxPower == 0:
+    Registers[4] = WriteField(Registers[4], 8, 1, 0)
+  else:
+    Registers[4] = WriteField(Registers[4], 6, 2, AuxPower - 1)
+    Registers[4] = WriteField(Registers[4], 8, 1, 1)
+    Registers[4] = WriteField(Registers[4], 9, 1, 1 if AuxMode == "FUNDAMENTAL" else 0)
+  return Registers
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(fromfile_prefix_chars='@')
+    parser.add_argument("--ref", type=int, default=10000000, help="reference frequency in Hz")
+    parser.add_argument("--r", type=int, default=1, help="R divider")
+    parser.add_argument("--refmode", default="UNDIVIDED", choices=["UNDIVIDED", "HALF", "DOUBLE"], help="reference doubler/divide by 2")
+    parser.add_argument("--step", type=int, default=100000, help="channel step in Hz")
+    parser.add_argument("--frequencies", help="file with one frequency in Hz per line")
+    parser.add_argument("--start", type=int, help="start frequency in Hz")
+    parser.add_argument("--stop", type=int, help="stop frequency in Hz")
+    parser.add_argument("--increment", type=int, help="frequency increment in Hz")
+    parser.add_argument("--format", default="COMPACT", choices=["COMPACT", "FULL"], help="table format")
+    parser.add_argument("--power", type=int, default=4, help="power level for FULL tables (0-4)")
+    parser.add_argument("--auxpower", type=int, default=0, help="auxiliary power level for FULL tables (0-4)")
+    parser.add_argument("--auxmode", default="DIVIDED", choices=["DIVIDED", "FUNDAMENTAL"], help="auxiliary output mode for FULL tables")
+    parser.add_argument("--name", default="MAX2870_Table", help="table name")
+    parser.add_argument("--output", help="header file (standard output if not specified)")
+    args = parser.parse_args()
+
+    Frequencies = []
+    if args.frequencies != None:
+      with open(args.frequencies) as FrequencyFile:
+        for line in FrequencyFile:
+          line = line.strip()
+          if line != "" and line[0] != "#":
+            Frequencies.append(int(line))
+    elif args.start != None and args.stop != None and args.increment != None and args.increment > 0:
+      Frequencies = list(range(args.start, (args.stop + 1), args.increment))
+    else:
+      sys.exit("Frequencies must be specified with --frequencies or --start/--stop/--increment")
+
+    Template = TemplateRegisters(args.ref, args.r, args.refmode, args.power, args.auxpower, args.auxmode)
+    Lines = []
+    Lines.append("// generated by MAX2870table.py - " + " ".join(sys.argv[1:]))
+    Lines.append("// reference " + str(args.ref) + " Hz, R " + str(args.r) + ", " + args.refmode + ", channel step " + str(args.step) + " Hz")
+    Lines.append("")
+    Lines.append("#include <MAX2870.h>")
+    Lines.append("")
+    Lines.append("const uint16_t " + args.name + "_Steps = " + str(len(Frequencies)) + ";")
+    if args.format == "COMPACT":
+      Lines.append("const MAX2870CompactStep " + args.name + "[] PROGMEM = {")
+    else:
+      Lines.append("const uint32_t " + args.name + "[][MAX2870_RegsToWrite] PROGMEM = {")
+    for Frequency in Frequencies:
+      N, Mod, Frac, RfDivSel, FrequencyError = CalculateChannel(Frequency, args.ref, args.r, args.refmode, args.step)
+      Registers = PackRegisters(Template, N, Mod, Frac, RfDivSel)
+      Comment = " // " + str(Frequency) + " Hz"
+      if FrequencyError != 0:
+        Comment += " (error " + str(FrequencyError) + " Hz)"
+      if args.format == "COMPACT":
+        Lines.append("  {0x%08X, 0x%04X}," % (Registers[0], (Mod | (RfDivSel << 12))) + Comment)
+      else:
+        Lines.append("  {" + ", ".join("0x%08X" % Register for Register in Registers) + "}," + Comment)
+    Lines.append("};")
+
+    if args.output != None:
+      with open(args.output, "w", newline="\r\n") as HeaderFile:
+        HeaderFile.write("\n".join(Lines) + "\n")
+    else:
+      print("\n".join(Lines))
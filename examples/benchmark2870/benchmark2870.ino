@@ -0,0 +1,235 @@
+/*
+
+  MAX2870 setf() benchmark by Bryce Cherry
+
+  Times setf()/setfFast() for every frequency on a grid (every 100 kHz from 23.4375 MHz to 6 GHz by default) under channel step mode,
+  channel step mode with a frequency string, precision frequency mode and setfFast() and prints the results once at the serial port rate
+  A MAX2870 is not required - register writes are discarded by BenchmarkTransport instead of being sent unless it is changed to MAX2870HardwareSPI
+  Times are from micros() which has a resolution of 4 uS on 16 MHz AVR boards - percentiles are the upper limit of the histogram bin
+
+*/
+
+#include <MAX2870.h>
+
+class DiscardTransport { // discards the register words instead of writing them
+  public:
+    void begin(uint8_t SSpin) {
+      (void)SSpin;
+    }
+    void write(const uint8_t *Buffer, uint8_t Registers) {
+      (void)Buffer;
+      (void)Registers;
+    }
+    bool read(uint32_t *Value) {
+      (void)Value;
+      return false;
+    }
+};
+
+typedef DiscardTransport BenchmarkTransport; // MAX2870HardwareSPI to include the time taken to write the registers to a connected MAX2870
+
+MAX2870Device<BenchmarkTransport> vfo;
+
+// use hardware SPI pins for Data and Clock
+const byte SSpin = 10; // LE
+const byte LockPin = 8; // LD - MISO is left for MUXOUT register readback
+const byte CEpin = 9;
+
+const uint64_t GridStart = 23437500ULL;
+const uint64_t GridStop = 6000000000ULL;
+const unsigned long GridStep = 100000UL;
+const unsigned long ReferenceFrequency = 10000000UL;
+const word ReferenceDivider = 1;
+const unsigned long ChannelStep = 12500UL; // every grid frequency is a multiple of this and PFD / ChannelStep is within the MOD range for setfFast()
+const unsigned long PrecisionTolerance = 0; // Hz
+const unsigned long CalculationTimeout = 0; // mS - 0 to disable
+
+const byte HistogramBins = 64;
+const word HistogramBinWidth = 8; // uS
+unsigned long Histogram[(HistogramBins + 1)]; // the last bin is for times beyond the histogram
+
+const byte BenchmarkChannelStep = 0;
+const byte BenchmarkChannelStepString = 1;
+const byte BenchmarkPrecision = 2;
+const byte BenchmarkFast = 3;
+
+const unsigned long SerialPortRate = 9600;
+
+#if defined(__AVR__)
+extern char *__brkval;
+extern char __heap_start;
+
+unsigned int HeapTop() {
+  if (__brkval == 0) {
+    return (unsigned int)&__heap_start;
+  }
+  return (unsigned int)__brkval;
+}
+#endif
+
+void PrintFrequency(uint64_t value) { // Print does not support 64 bit values on all boards
+  if (value >= 1000000000ULL) {
+    Serial.print((unsigned long)(value / 1000000000ULL));
+    unsigned long LowerDigits = (value % 1000000000ULL);
+    for (unsigned long i = 100000000UL; i > 1 && LowerDigits < i; i /= 10) { // leading zeros
+      Serial.print(F("0"));
+    }
+    Serial.print(LowerDigits);
+  }
+  else {
+    Serial.print((unsigned long)value);
+  }
+}
+
+void FrequencyToString(uint64_t value, char *buffer) {
+  char Digits[11];
+  byte DigitCount = 0;
+  do {
+    Digits[DigitCount] = '0' + (value % 10);
+    DigitCount++;
+    value /= 10;
+  } while (value != 0);
+  for (int i = 0; i < DigitCount; i++) {
+    buffer[i] = Digits[(DigitCount - 1 - i)];
+  }
+  buffer[DigitCount] = 0x00;
+}
+
+void PrintPercentile(byte Percent, unsigned long Calls) {
+  unsigned long Target = ((Calls * Percent) + 99) / 100;
+  unsigned long Count = 0;
+  Serial.print(F("  p"));
+  Serial.print(Percent);
+  Serial.print(F(" (uS): "));
+  for (int i = 0; i <= HistogramBins; i++) {
+    Count += Histogram[i];
+    if (Count >= Target) {
+      if (i == HistogramBins) {
+        Serial.print(F(">"));
+        Serial.println((unsigned long)HistogramBins * HistogramBinWidth);
+      }
+      else {
+        Serial.print(F("<="));
+        Serial.println((unsigned long)(i + 1) * HistogramBinWidth);
+      }
+      break;
+    }
+  }
+}
+
+void RunBenchmark(byte Benchmark, const __FlashStringHelper *Name) {
+  for (int i = 0; i <= HistogramBins; i++) {
+    Histogram[i] = 0;
+  }
+  unsigned long Calls = 0;
+  unsigned long Errors = 0;
+  unsigned long Warnings = 0;
+  unsigned long TotalTime = 0;
+  unsigned long MinimumTime = 0xFFFFFFFF;
+  unsigned long MaximumTime = 0;
+  uint64_t WorstFrequency = 0;
+  unsigned long RegistersWritten = 0;
+  char FrequencyString[12];
+#if defined(__AVR__)
+  unsigned int HeapBefore = HeapTop();
+#endif
+  vfo.setf(GridStart, 4, 0, MAX2870_AUX_DIVIDED, false, 0, 0); // start from the same state for each benchmark
+  for (uint64_t Frequency = GridStart; Frequency <= GridStop; Frequency += GridStep) {
+    if (Benchmark == BenchmarkChannelStepString) {
+      FrequencyToString(Frequency, FrequencyString); // not timed
+    }
+    int ErrorCode;
+    unsigned long StartTime = micros();
+    switch (Benchmark) {
+      case BenchmarkChannelStep:
+        ErrorCode = vfo.setf(Frequency, 4, 0, MAX2870_AUX_DIVIDED, false, 0, 0);
+        break;
+      case BenchmarkChannelStepString:
+        ErrorCode = vfo.setf(FrequencyString, 4, 0, MAX2870_AUX_DIVIDED, false, 0, 0);
+        break;
+      case BenchmarkPrecision:
+        ErrorCode = vfo.setf(Frequency, 4, 0, MAX2870_AUX_DIVIDED, true, PrecisionTolerance, CalculationTimeout);
+        break;
+      default:
+        ErrorCode = vfo.setfFast(Frequency);
+        break;
+    }
+    unsigned long ElapsedTime = micros() - StartTime;
+    Calls++;
+    if (ErrorCode == MAX2870_WARNING_FREQUENCY_ERROR) {
+      Warnings++;
+    }
+    else if (ErrorCode != MAX2870_ERROR_NONE) {
+      Errors++;
+    }
+    RegistersWritten += vfo.MAX2870_RegsWrittenCount;
+    TotalTime += ElapsedTime;
+    if (ElapsedTime < MinimumTime) {
+      MinimumTime = ElapsedTime;
+    }
+    if (ElapsedTime > MaximumTime) {
+      MaximumTime = ElapsedTime;
+      WorstFrequency = Frequency;
+    }
+    unsigned long Bin = ElapsedTime / HistogramBinWidth;
+    if (Bin > HistogramBins) {
+      Bin = HistogramBins;
+    }
+    Histogram[Bin]++;
+  }
+  Serial.println(Name);
+  Serial.print(F("  Calls: "));
+  Serial.println(Calls);
+  Serial.print(F("  Errors/warnings: "));
+  Serial.print(Errors);
+  Serial.print(F("/"));
+  Serial.println(Warnings);
+  Serial.print(F("  Registers written per call: "));
+  Serial.print((RegistersWritten / Calls));
+  Serial.print(F("."));
+  unsigned long RegistersWrittenDecimal = (((RegistersWritten % Calls) * 100) / Calls);
+  if (RegistersWrittenDecimal < 10) {
+    Serial.print(F("0"));
+  }
+  Serial.println(RegistersWrittenDecimal);
+  Serial.print(F("  Minimum/mean/maximum (uS): "));
+  Serial.print(MinimumTime);
+  Serial.print(F("/"));
+  Serial.print((TotalTime / Calls));
+  Serial.print(F("/"));
+  Serial.println(MaximumTime);
+  PrintPercentile(50, Calls);
+  PrintPercentile(90, Calls);
+  PrintPercentile(99, Calls);
+  Serial.print(F("  Worst case frequency (Hz): "));
+  PrintFrequency(WorstFrequency);
+  Serial.println();
+#if defined(__AVR__)
+  Serial.print(F("  Heap growth (bytes): "));
+  Serial.println((HeapTop() - HeapBefore));
+#endif
+}
+
+void setup() {
+  Serial.begin(SerialPortRate);
+  vfo.init(SSpin, LockPin, true, CEpin, true);
+  digitalWrite(CEpin, HIGH); // enable the MAX2870 when one is connected
+  vfo.setrf(ReferenceFrequency, ReferenceDivider, MAX2870_REF_UNDIVIDED);
+  vfo.SetStepFreq(ChannelStep);
+  Serial.print(F("CPU speed (MHz): "));
+  Serial.println((F_CPU / 1000000UL));
+  Serial.print(F("Grid (Hz): "));
+  PrintFrequency(GridStart);
+  Serial.print(F(" to "));
+  PrintFrequency(GridStop);
+  Serial.print(F(" step "));
+  Serial.println(GridStep);
+  RunBenchmark(BenchmarkChannelStep, F("setf() channel step mode"));
+  RunBenchmark(BenchmarkChannelStepString, F("setf() channel step mode with frequency string"));
+  RunBenchmark(BenchmarkPrecision, F("setf() precision frequency mode"));
+  RunBenchmark(BenchmarkFast, F("setfFast()"));
+  Serial.println(F("Benchmark complete"));
+}
+
+void loop() {
+}
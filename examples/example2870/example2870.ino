@@ -2,31 +2,38 @@
 
   MAX2870 demo by Bryce Cherry
 
+  Wiring: LE to SSpin (10), CE to CEpin (9), LD to LockPin (8) and MUXOUT to MISO (12 on an Uno) for READBACK
+
   Commands:
   REF reference_frequency_in_Hz reference_divider reference_multiplier(UNDIVIDED/DOUBLE/HALF) - Set reference frequency, reference divider and reference doubler/divide by 2
   (FREQ/FREQ_P) frequency_in_Hz power_level(0-4) aux_power_level(0-4) aux_frequency_output(DIVIDED/FUNDAMENTAL) frequency_tolerance_in_Hz calculation_timeout_in_mS - set RF frequency (FREQ_P sets precision mode), power level, auxiliary output frequency mode, frequency tolerance (precision mode only), calculation timeout (precision mode only - 0 to disable)
   FREQ_DIRECT R_divider INT_value MOD_value FRAC_value RF_DIVIDER_value PRESCALER_value FRACTIONAL_MODE(true/false) - sets RF parameters directly
   (BURST/BURST_CONT/BURST_SINGLE) on_time_in_uS off time_in_uS count (AUX) - perform a on/off burst on frequency and power level set with FREQ/FREQ_P - count is only used with BURST_CONT - if AUX is used, will burst on the auxiliary output; otherwise, it will burst on the primary output
   SWEEP start_frequency stop_frequency step_in_mS(1-32767) power_level(1-4) aux_power_level(0-4) aux_frequency_output(DIVIDED/FUNDAMENTAL) - sweep RF frequency
+  SWEEP_LOCK start_frequency stop_frequency step_in_mS(1-32767) power_level(1-4) aux_power_level(0-4) aux_frequency_output(DIVIDED/FUNDAMENTAL) settle_time_in_uS - as SWEEP with each step advancing settle_time_in_uS after the lock pin goes high (step_in_mS is the longest wait for lock)
   STEP frequency_in_Hz - set channel step
   STATUS - view status of VFO
+  READBACK - view R6 read back from MUXOUT (MUXOUT must be connected to MISO) - die revision, power on reset, VAS state machine activity and VCO band
+  LOCK_STATS - view lock time statistics for each RF divider band (measured from the LD pin after every retune) and clear them
   CE (ON/OFF) - enable/disable MAX2870
   CP_CURRENT current_in_mA_floating - adjust charge pump current to suit your loop filter (default library value is 2.56 mA)
   PD_POLARITY (INVERTING/NONINVERTING) - change phase detector polarity (default library is noninverting for passive/noninverting loop filters)
+  SEARCH (RATIONAL/LINEAR) - FRAC/MOD search used by FREQ_P (default library is RATIONAL - LINEAR is the reference search through every MOD value)
+  FAST_LOCK (OFF/HARDWARE/SOFTWARE) timeout_in_uS boost_current_in_mA_floating - fast lock after each retune from the MAX2870 (HARDWARE - set CP_CURRENT to 0.32 with a loop filter using the SW pin) or by writing the boost charge pump current with each retune and restoring CP_CURRENT after the timeout (SOFTWARE)
+  VCO_CACHE (OFF/ON/LEARN/BAND/PRINT) - VCO band selection by the VAS state machine (OFF - default), from the VCO band cache (ON), from the VCO band cache with the VCO band read back for each new VCO frequency (LEARN - requires MUXOUT connected to MISO), find and cache the VCO band of the current frequency from the readback or by trying each band with the lock pin (BAND - up to 64 mS) or print the VCO band cache for importVCOCache()
 
 */
 
 #include <MAX2870.h>
-#include <BigNumber.h> // obtain at https://github.com/nickgammon/BigNumber
 
 MAX2870 vfo;
 
 // use hardware SPI pins for Data and Clock
 const byte SSpin = 10; // LE
-const byte LockPin = 12; // MISO
+const byte LockPin = 8; // LD - MISO is left for MUXOUT register readback
 const byte CEpin = 9;
 
-const word SweepSteps = 14; // SweepSteps * ((4 * 6) + (2 * 3)) is the temporary memory calculation (remember to leave enough for BigNumber) - 14 is the limit which will not cause an ATmega328 based board to hang during a frequency sweep
+const word SweepSteps = 1000; // steps are calculated during the sweep so this is not limited by RAM
 
 const int CommandSize = 50;
 char Command[CommandSize];
@@ -90,6 +97,29 @@ void getField (char* buffer, int index) {
   buffer[FieldPos] = '\0';
 }
 
+uint64_t ParseFrequency(const char* buffer) { // decimal places are ignored
+  uint64_t value = 0;
+  for (int i = 0; buffer[i] >= '0' && buffer[i] <= '9'; i++) {
+    value *= 10;
+    value += (buffer[i] - '0');
+  }
+  return value;
+}
+
+void PrintFrequency(uint64_t value) { // Print does not support 64 bit values on all boards
+  if (value >= 1000000000ULL) {
+    Serial.print((unsigned long)(value / 1000000000ULL));
+    unsigned long LowerDigits = (value % 1000000000ULL);
+    for (unsigned long i = 100000000UL; i > 1 && LowerDigits < i; i /= 10) { // leading zeros
+      Serial.print(F("0"));
+    }
+    Serial.print(LowerDigits);
+  }
+  else {
+    Serial.print((unsigned long)value);
+  }
+}
+
 void PrintVFOstatus() {
   Serial.print(F("R: "));
   Serial.println(vfo.ReadR());
@@ -191,6 +221,12 @@ void PrintErrorCode(byte value) {
     case MAX2870_ERROR_PFD_LIMITS:
       Serial.println(F("PFD frequency is out of range"));
       break;
+    case MAX2870_ERROR_SWEEP_RANGE:
+      Serial.println(F("Sweep start/stop/step frequency is invalid"));
+      break;
+    case MAX2870_ERROR_FAST_LOCK_TIMEOUT:
+      Serial.println(F("Fast lock timeout is out of range for the PFD frequency"));
+      break;
   }
 }
 
@@ -200,8 +236,38 @@ void setup() {
   digitalWrite(CEpin, HIGH); // enable the MAX2870
 }
 
+void PrintLockStatistics() {
+  for (int Band = 0; Band < MAX2870_LOCK_BANDS; Band++) {
+    MAX2870LockStatistics Statistics;
+    vfo.ReadLockStatistics(Band, &Statistics);
+    if (Statistics.Locks != 0 || Statistics.Timeouts != 0) {
+      Serial.print(F("RF divider "));
+      Serial.print((1 << Band));
+      Serial.print(F(": locks "));
+      Serial.print(Statistics.Locks);
+      Serial.print(F(" timeouts "));
+      Serial.print(Statistics.Timeouts);
+      Serial.print(F(" min/mean/max (uS) "));
+      Serial.print(Statistics.Minimum);
+      Serial.print(F("/"));
+      Serial.print(Statistics.Mean);
+      Serial.print(F("/"));
+      Serial.println(Statistics.Maximum);
+      Serial.print(F("  histogram:"));
+      for (int i = 0; i < MAX2870_LOCK_HISTOGRAM_BINS; i++) {
+        Serial.print(F(" "));
+        Serial.print(Statistics.Histogram[i]);
+      }
+      Serial.println();
+    }
+  }
+  vfo.clearLockStatistics();
+}
+
 void loop() {
   static int ByteCount = 0;
+  vfo.serviceLock(); // lock time of the last retune
+  vfo.serviceFastLock(); // charge pump current after a retune under FAST_LOCK SOFTWARE
   if (Serial.available() > 0) {
     char value = Serial.read();
     if (value != '\n' && ByteCount < CommandSize) {
@@ -396,12 +462,12 @@ void loop() {
           }
         }
       }
-      else if (strcmp(field, "SWEEP") == 0) {
-        BigNumber::begin(12); // will finish on setf()
+      else if (strcmp(field, "SWEEP") == 0 || strcmp(field, "SWEEP_LOCK") == 0) {
+        bool LockGated = (strcmp(field, "SWEEP_LOCK") == 0);
         getField(field, 1);
-        BigNumber BN_StartFrequency(field);
+        uint64_t StartFrequency = ParseFrequency(field);
         getField(field, 2);
-        BigNumber BN_StopFrequency(field);
+        uint64_t StopFrequency = ParseFrequency(field);
         getField(field, 3);
         word SweepStepTime = atoi(field);
         getField(field, 4);
@@ -419,113 +485,80 @@ void loop() {
         else {
           ValidField = false;
         }
+        unsigned long SettleTime = 0;
+        if (LockGated == true) {
+          getField(field, 7);
+          SettleTime = atol(field);
+        }
         if (ValidField == true) {
-          if (BN_StartFrequency < BN_StopFrequency) {
-            char tmpstr[12];
-            ultoa(vfo.MAX2870_ChanStep, tmpstr, 10);
-            char tmpstr2[12];
-            ultoa(SweepSteps, tmpstr2, 10);
-            BigNumber BN_StepSize = ((BN_StopFrequency - BN_StartFrequency) / (BigNumber(tmpstr2)) - BigNumber("1"));
-            if (BN_StepSize >= BigNumber(tmpstr)) {
-              BigNumber BN_StepSizeRounding = (BN_StepSize / BigNumber(tmpstr));
-              uint32_t StepSizeRounding = (uint32_t)((uint32_t) BN_StepSizeRounding);
-              ultoa(StepSizeRounding, tmpstr2, 10);
-              BN_StepSize = (BigNumber(tmpstr) * BigNumber(tmpstr2));
-              char StepSize[14];
-              char StartFrequency[14];
-              char* tempstring1 = BN_StepSize.toString();
-              for (int i = 0; i < 14; i++) {
-                byte temp = tempstring1[i];
-                if (temp == '.') {
-                  StepSize[i] = 0x00;
-                  break;
+          if (StartFrequency < StopFrequency) {
+            uint64_t StepSize = ((StopFrequency - StartFrequency) / SweepSteps);
+            if (StepSize > vfo.MAX2870_ChanStep) {
+              StepSize--;
+              StepSize -= (StepSize % vfo.MAX2870_ChanStep); // round down to the channel step
+              byte ErrorCode = vfo.setf(StartFrequency, PowerLevel, AuxPowerLevel, AuxFrequencyDivider, false, 0, 0); // sets the power levels used by startSweep()
+              if (ErrorCode == MAX2870_ERROR_NONE || ErrorCode == MAX2870_WARNING_FREQUENCY_ERROR) {
+                FlushSerialBuffer();
+                if (LockGated == true) {
+                  ErrorCode = vfo.startSweepLocked(StartFrequency, (StartFrequency + (StepSize * (SweepSteps - 1))), StepSize, SettleTime, ((unsigned long)SweepStepTime * 1000), true);
                 }
-                StepSize[i] = temp;
-              }
-              free(tempstring1);
-              char* tempstring2 = BN_StartFrequency.toString();
-              BigNumber::finish();
-              for (int i = 0; i < 14; i++) {
-                byte temp = tempstring2[i];
-                if (temp == '.') {
-                  StepSize[i] = 0x00;
-                  break;
+                else {
+                  ErrorCode = vfo.startSweep(StartFrequency, (StartFrequency + (StepSize * (SweepSteps - 1))), StepSize, ((unsigned long)SweepStepTime * 1000), true);
                 }
-                StartFrequency[i] = temp;
               }
-              free(tempstring2);
-              uint32_t regs[(MAX2870_RegsToWrite * SweepSteps)];
-              uint32_t reg_temp[MAX2870_RegsToWrite];
-              for (word SweepCount = 0; SweepCount < SweepSteps; SweepCount++) {
-                Serial.print(F("Calculating step "));
-                Serial.print(SweepCount);
-                char CurrentFrequency[14];
-                BigNumber::begin(12);
-                BigNumber BN_CurrentFrequency = (BigNumber(StartFrequency) + (BigNumber(StepSize) * BigNumber(SweepCount)));
-                char* tempstring3 = BN_CurrentFrequency.toString();
-                BigNumber::finish();
-                for (int y = 0; y < 14; y++) {
-                  byte temp = tempstring3[y];
-                  if (temp == '.') {
-                    CurrentFrequency[y] = 0x00;
-                    break;
-                  }
-                  CurrentFrequency[y] = temp;
-                }
-                free(tempstring3);
-                Serial.print(F(" - frequency is now "));
-                Serial.print(CurrentFrequency);
-                Serial.println(F(" Hz"));
-                byte ErrorCode = vfo.setf(CurrentFrequency, PowerLevel, AuxPowerLevel, AuxFrequencyDivider, false, 0, 0);
-                if (ErrorCode != MAX2870_ERROR_NONE) {
-                  ValidField = false;
-                  PrintErrorCode(ErrorCode);
-                  break;
-                }
-                PrintVFOstatus();
-                vfo.ReadSweepValues(reg_temp);
-                for (int y = 0; y < MAX2870_RegsToWrite; y++) {
-                  regs[(y + (MAX2870_RegsToWrite * SweepCount))] = reg_temp[y];
-                }
+              if (ErrorCode != MAX2870_ERROR_NONE) {
+                ValidField = false;
+                PrintErrorCode(ErrorCode);
+              }
+              else {
+                Serial.print(F("Sweeping "));
+                Serial.print(SweepSteps);
+                Serial.print(F(" steps from "));
+                PrintFrequency(StartFrequency);
+                Serial.print(F(" Hz in "));
+                PrintFrequency(StepSize);
+                Serial.println(F(" Hz steps"));
               }
               if (ValidField == true) {
-                Serial.println(F("Now sweeping"));
-                FlushSerialBuffer();
-                while (true) {
+                unsigned long SweepsCompleted = 0;
+                while (vfo.MAX2870_SweepRunning == true) {
                   if (Serial.available() > 0) {
+                    vfo.stopSweep();
                     break;
                   }
-                  for (word SweepCount = 0; SweepCount < SweepSteps; SweepCount++) {
-                    if (Serial.available() > 0) {
-                      break;
-                    }
-                    for (int y = 0; y < MAX2870_RegsToWrite; y++) {
-                      reg_temp[y] = regs[(y + (MAX2870_RegsToWrite * SweepCount))];
-                    }
-                    vfo.WriteSweepValues(reg_temp);
-                    delay(SweepStepTime);
+                  ErrorCode = vfo.serviceSweep(); // the next step is calculated while the current step dwells
+                  vfo.serviceLock();
+                  if (ErrorCode != MAX2870_ERROR_NONE) {
+                    PrintErrorCode(ErrorCode);
                   }
-                  Serial.print(F("*"));
+                  if ((vfo.MAX2870_SweepStepsWritten / SweepSteps) > SweepsCompleted) {
+                    SweepsCompleted++;
+                    Serial.print(F("*"));
+                  }
+                }
+                Serial.println();
+                if (vfo.ReadFrequencyError() != 0) {
+                  PrintErrorCode(MAX2870_WARNING_FREQUENCY_ERROR);
+                }
+                Serial.print(F("Steps calculated late: "));
+                Serial.println(vfo.MAX2870_SweepUnderruns);
+                if (LockGated == true) {
+                  Serial.print(F("Steps without lock: "));
+                  Serial.println(vfo.MAX2870_SweepLockTimeouts);
                 }
-                Serial.print(F(""));
                 Serial.println(F("End of sweep"));
               }
             }
             else {
-              BigNumber::finish();
               Serial.println(F("Calculated frequency step is smaller than preset frequency step"));
               ValidField = false;
             }
           }
           else {
-            BigNumber::finish();
             Serial.println(F("Stop frequency must be greater than start frequency"));
             ValidField = false;
           }
         }
-        else {
-          BigNumber::finish();
-        }
       }
       else if (strcmp(field, "STEP") == 0) {
         getField(field, 1);
@@ -538,14 +571,32 @@ void loop() {
       }
       else if (strcmp(field, "STATUS") == 0) {
         PrintVFOstatus();
-        SPI.end();
         if (digitalRead(LockPin) == LOW) {
           Serial.println(F("Lock pin LOW"));
         }
         else {
           Serial.println(F("Lock pin HIGH"));
         }
-        SPI.begin();
+      }
+      else if (strcmp(field, "READBACK") == 0) {
+        MAX2870Status Status;
+        if (vfo.readStatusRegister(&Status) == MAX2870_ERROR_NONE) {
+          Serial.print(F("Die: "));
+          Serial.println(Status.Die);
+          Serial.print(F("Power on reset: "));
+          Serial.println(Status.PowerOnReset);
+          Serial.print(F("VAS active: "));
+          Serial.println(Status.VASActive);
+          Serial.print(F("VCO band: "));
+          Serial.println(Status.VCO);
+        }
+        else {
+          Serial.println(F("Readback failed - MUXOUT is not connected to MISO"));
+          ValidField = false;
+        }
+      }
+      else if (strcmp(field, "LOCK_STATS") == 0) {
+        PrintLockStatistics();
       }
       else if (strcmp(field, "CE") == 0) {
         getField(field, 1);
@@ -576,6 +627,75 @@ void loop() {
           ValidField = false;
         }
       }
+      else if (strcmp(field, "SEARCH") == 0) {
+        getField(field, 1);
+        if (strcmp(field, "RATIONAL") == 0) {
+          vfo.setPrecisionSearch(MAX2870_PRECISION_SEARCH_RATIONAL);
+        }
+        else if (strcmp(field, "LINEAR") == 0) {
+          vfo.setPrecisionSearch(MAX2870_PRECISION_SEARCH_LINEAR);
+        }
+        else {
+          ValidField = false;
+        }
+      }
+      else if (strcmp(field, "FAST_LOCK") == 0) {
+        getField(field, 2);
+        unsigned long FastLockTimeout = atol(field);
+        getField(field, 3);
+        float BoostCurrent = atof(field);
+        getField(field, 1);
+        byte FastLockMode = MAX2870_FAST_LOCK_OFF;
+        if (strcmp(field, "HARDWARE") == 0) {
+          FastLockMode = MAX2870_FAST_LOCK_HARDWARE;
+        }
+        else if (strcmp(field, "SOFTWARE") == 0) {
+          FastLockMode = MAX2870_FAST_LOCK_SOFTWARE;
+        }
+        else if (strcmp(field, "OFF") != 0) {
+          ValidField = false;
+        }
+        if (ValidField == true) {
+          byte ErrorCode = vfo.setFastLock(FastLockMode, FastLockTimeout, BoostCurrent);
+          if (ErrorCode != MAX2870_ERROR_NONE) {
+            ValidField = false;
+            PrintErrorCode(ErrorCode);
+          }
+        }
+      }
+      else if (strcmp(field, "VCO_CACHE") == 0) {
+        getField(field, 1);
+        if (strcmp(field, "OFF") == 0) {
+          vfo.setVCOCache(MAX2870_VCO_CACHE_OFF);
+        }
+        else if (strcmp(field, "ON") == 0) {
+          vfo.setVCOCache(MAX2870_VCO_CACHE_ON);
+        }
+        else if (strcmp(field, "LEARN") == 0) {
+          vfo.setVCOCache(MAX2870_VCO_CACHE_LEARN);
+        }
+        else if (strcmp(field, "BAND") == 0) {
+          byte ErrorCode = vfo.learnVCOBand();
+          if (ErrorCode != MAX2870_ERROR_NONE) {
+            ValidField = false;
+            PrintErrorCode(ErrorCode);
+          }
+        }
+        else if (strcmp(field, "PRINT") == 0) {
+          byte Cache[MAX2870_VCO_CACHE_SIZE];
+          vfo.exportVCOCache(Cache);
+          for (int i = 0; i < MAX2870_VCO_CACHE_SIZE; i++) {
+            Serial.print(Cache[i]);
+            if (i < (MAX2870_VCO_CACHE_SIZE - 1)) {
+              Serial.print(F(", "));
+            }
+          }
+          Serial.println();
+        }
+        else {
+          ValidField = false;
+        }
+      }
       else {
         ValidField = false;
       }
@@ -0,0 +1,129 @@
+/*
+
+  MAX2870 timer interrupt playback example by Bryce Cherry
+
+  Plays back a compact sweep table from a timer interrupt with a different dwell time for each step in sequential or pseudo-random (frequency hopping) order
+  and prints the number of steps written, the step to step jitter, the step write time and the registers written per step once per second while the main loop is free
+  Timer1 (16 bit) is used on AVR boards - on other architectures tick() is called from loop() instead as the timer setup is specific to each architecture
+  While playback is running the main loop only reads the playback statistics - any other use of vfo (setf(), setPowerLevel() etc.) would race with tick()
+
+*/
+
+#include <MAX2870.h>
+
+MAX2870 vfo;
+
+// use hardware SPI pins for Data and Clock
+const byte SSpin = 10; // LE
+const byte LockPin = 8; // LD - MISO is left for MUXOUT register readback
+const byte CEpin = 9;
+
+const unsigned long ReferenceFrequency = 10000000UL;
+const word ReferenceDivider = 1;
+const uint64_t StartFrequency = 2400000000ULL;
+const uint64_t StepFrequency = 1000000ULL;
+const word PlaybackSteps = 100; // PlaybackSteps * (sizeof(MAX2870CompactStep) + 2) bytes of RAM
+const unsigned long TickPeriod = 100; // uS
+const word ShortDwell = 10; // ticks
+const word LongDwell = 50; // ticks
+const byte HopOrder = MAX2870_PLAYBACK_ORDER_RANDOM; // or MAX2870_PLAYBACK_ORDER_SEQUENTIAL
+const word HopSeed = 1; // the same seed gives the same hop order
+
+MAX2870CompactStep Steps[PlaybackSteps];
+word DwellTicks[PlaybackSteps];
+
+const unsigned long SerialPortRate = 9600;
+
+#if defined(__AVR__)
+ISR(TIMER1_COMPA_vect) {
+  vfo.tick();
+}
+
+void StartTimer() {
+  noInterrupts();
+  TCCR1A = 0;
+  TCCR1B = 0;
+  TCNT1 = 0;
+  OCR1A = ((F_CPU / 8 / 1000000UL) * TickPeriod) - 1; // prescaler of 8
+  TCCR1B = (1 << WGM12) | (1 << CS11); // CTC mode
+  TIMSK1 = (1 << OCIE1A);
+  interrupts();
+}
+#endif
+
+void setup() {
+  Serial.begin(SerialPortRate);
+  vfo.init(SSpin, LockPin, true, CEpin, true);
+  digitalWrite(CEpin, HIGH); // enable the MAX2870
+  vfo.setrf(ReferenceFrequency, ReferenceDivider, MAX2870_REF_UNDIVIDED);
+  vfo.SetStepFreq(StepFrequency);
+  vfo.setf(StartFrequency, 4, 0, MAX2870_AUX_DIVIDED, false, 0, 0);
+  uint16_t StepsPlanned = 0;
+  int ErrorCode = vfo.planSweepCompact(StartFrequency, (StartFrequency + (StepFrequency * (PlaybackSteps - 1))), StepFrequency, Steps, PlaybackSteps, &StepsPlanned);
+  if (ErrorCode != MAX2870_ERROR_NONE && ErrorCode != MAX2870_WARNING_FREQUENCY_ERROR) {
+    Serial.print(F("Sweep calculation error: "));
+    Serial.println(ErrorCode);
+    while (true) {
+    }
+  }
+  for (int i = 0; i < PlaybackSteps; i++) {
+    if ((i % 2) == 0) {
+      DwellTicks[i] = ShortDwell;
+    }
+    else {
+      DwellTicks[i] = LongDwell;
+    }
+  }
+#if defined(__AVR__)
+  SPI.usingInterrupt(255); // nothing else on the SPI bus may be interrupted by tick()
+#endif
+  vfo.setPlaybackOrder(HopOrder, HopSeed);
+  ErrorCode = vfo.startPlaybackCompact(Steps, StepsPlanned, DwellTicks, 0, TickPeriod, true); // refused under MAX2870_WRITE_MODE_QUEUE, MAX2870_VCO_CACHE_LEARN/ON or MAX2870_FAST_LOCK_HARDWARE
+  if (ErrorCode != MAX2870_ERROR_NONE) {
+    Serial.print(F("Playback error: "));
+    Serial.println(ErrorCode);
+    while (true) {
+    }
+  }
+#if defined(__AVR__)
+  StartTimer();
+#endif
+  Serial.print(F("Playing back "));
+  Serial.print(StepsPlanned);
+  Serial.print(F(" steps with a tick of "));
+  Serial.print(TickPeriod);
+  Serial.println(F(" uS"));
+}
+
+void loop() {
+#if !defined(__AVR__)
+  static unsigned long NextTick = micros();
+  if ((long)(micros() - NextTick) >= 0) {
+    NextTick += TickPeriod;
+    vfo.tick();
+  }
+#endif
+  static unsigned long NextReport = millis();
+  if ((long)(millis() - NextReport) >= 0) {
+    NextReport += 1000;
+    MAX2870PlaybackStatistics Statistics;
+    vfo.ReadPlaybackStatistics(&Statistics);
+    Serial.print(F("Steps written: "));
+    Serial.print(Statistics.StepsWritten);
+    Serial.print(F(" jitter (uS): "));
+    Serial.print(Statistics.MinimumJitter);
+    Serial.print(F(" to "));
+    Serial.print(Statistics.MaximumJitter);
+    Serial.print(F(" write time minimum/mean/maximum (uS): "));
+    Serial.print(Statistics.MinimumWriteTime);
+    Serial.print(F("/"));
+    Serial.print(Statistics.MeanWriteTime);
+    Serial.print(F("/"));
+    Serial.print(Statistics.MaximumWriteTime);
+    if (Statistics.StepsWritten != 0) {
+      Serial.print(F(" registers per step: "));
+      Serial.print((float)Statistics.RegistersWritten / Statistics.StepsWritten);
+    }
+    Serial.println();
+  }
+}
@@ -0,0 +1,391 @@
+/*!
+   @file benchmark_host.cpp
+
+   This is part of the host (Linux) build of the Arduino Library for the MAX2870 PLL wideband frequency synthesier
+
+   Host version of benchmark2870.ino - times setf()/setfMilliHz()/setfFast() for every frequency on a grid (every 100 kHz from
+   23.4375 MHz to 6 GHz by default) and reports nS per call from the host steady clock with percentiles, the worst case frequency,
+   registers written per call and heap allocations per call. Precision frequency mode is timed off the grid (each grid frequency
+   moved by a pseudo-random offset of up to PrecisionOffsetRange Hz so that most frequencies need a fractional FRAC/MOD search)
+   for each of PrecisionTolerances[] with the rational search and with the linear search as the baseline, and the mean and
+   p99 of both are compared in a table at the end. The sweep benchmarks time planSweep()/planSweepCompact() over the same
+   grid in blocks of SweepBlockSteps steps and serviceSweep() with no dwell (one step calculated and written per call) and report
+   nS per step. The simulated bus time of each call (HostBus.Now - the pin writes and SPI bytes at the timing of HostBus.h)
+   is reported beside the host time as the retune latency on the Arduino bus, e.g. one word for a setfFast() hop within the
+   same RF divider band. Allocations are counted by hooks on malloc()/calloc()/realloc()
+   (linked with --wrap, with free() wrapped for operator delete) and operator new while each call is timed.
+
+   Registers are written to the simulated bus (HostBus.h) with event recording off so that the stand-ins do not allocate.
+
+   Usage: benchmark_host [GridStep (Hz) - default 100000]
+
+*/
+
+#include <MAX2870.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <new>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+
+// allocation hooks - only counted while a call is timed
+static bool AllocationCounting = false;
+static unsigned long Allocations = 0;
+
+extern "C" {
+  void *__real_malloc(size_t size);
+  void *__real_calloc(size_t count, size_t size);
+  void *__real_realloc(void *pointer, size_t size);
+  void __real_free(void *pointer);
+
+  void *__wrap_malloc(size_t size) {
+    if (AllocationCounting) {
+      Allocations++;
+    }
+    return __real_malloc(size);
+  }
+
+  void *__wrap_calloc(size_t count, size_t size) {
+    if (AllocationCounting) {
+      Allocations++;
+    }
+    return __real_calloc(count, size);
+  }
+
+  void *__wrap_realloc(void *pointer, size_t size) {
+    if (AllocationCounting) {
+      Allocations++;
+    }
+    return __real_realloc(pointer, size);
+  }
+
+  void __wrap_free(void *pointer) {
+    __real_free(pointer);
+  }
+}
+
+void *operator new(size_t size) {
+  if (AllocationCounting) {
+    Allocations++;
+  }
+  void *pointer = __real_malloc((size == 0) ? 1 : size);
+  if (pointer == NULL) {
+    throw std::bad_alloc();
+  }
+  return pointer;
+}
+
+void *operator new[](size_t size) {
+  return operator new(size);
+}
+
+void operator delete(void *pointer) noexcept {
+  __real_free(pointer);
+}
+
+void operator delete[](void *pointer) noexcept {
+  __real_free(pointer);
+}
+
+void operator delete(void *pointer, size_t size) noexcept {
+  (void)size;
+  __real_free(pointer);
+}
+
+void operator delete[](void *pointer, size_t size) noexcept {
+  (void)size;
+  __real_free(pointer);
+}
+
+MAX2870 vfo;
+
+const uint8_t SSpin = 10; // LE
+const uint8_t LockPin = 8;
+const uint8_t CEpin = 9;
+
+const uint64_t GridStart = 23437500ULL;
+const uint64_t GridStop = 6000000000ULL;
+const uint32_t GridStepDefault = 100000UL;
+const uint32_t ReferenceFrequency = 10000000UL;
+const uint16_t ReferenceDivider = 1;
+const uint32_t ChannelStep = 12500UL; // every grid frequency is a multiple of this and PFD / ChannelStep is within the MOD range for setfFast()
+const uint32_t PrecisionTolerances[] = {0, 1, 100}; // Hz
+const uint8_t PrecisionToleranceCount = (sizeof(PrecisionTolerances) / sizeof(PrecisionTolerances[0]));
+const uint32_t PrecisionOffsetRange = 1000003UL; // Hz - prime so that the offsets are not on the PFD / MOD grid
+const uint32_t CalculationTimeout = 0; // mS - 0 to disable
+
+const uint8_t BenchmarkChannelStep = 0;
+const uint8_t BenchmarkChannelStepString = 1;
+const uint8_t BenchmarkPrecision = 2;
+const uint8_t BenchmarkFast = 3;
+const uint8_t BenchmarkMilliHz = 4;
+const uint8_t BenchmarkPrecisionLinear = 5;
+
+const uint8_t SweepBenchmarkPlan = 0;
+const uint8_t SweepBenchmarkPlanCompact = 1;
+const uint8_t SweepBenchmarkService = 2;
+
+const uint16_t SweepBlockSteps = 256;
+uint32_t SweepRegisters[(SweepBlockSteps * MAX2870_RegsToWrite)];
+MAX2870CompactStep SweepSteps[SweepBlockSteps];
+
+typedef std::chrono::steady_clock BenchmarkClock;
+
+struct BenchmarkResult {
+  uint64_t Mean; // nS
+  uint64_t P99; // nS
+};
+
+static uint64_t ElapsedNanoseconds(BenchmarkClock::time_point StartTime, BenchmarkClock::time_point EndTime) {
+  return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(EndTime - StartTime).count();
+}
+
+static uint64_t TimerOverhead() { // smallest interval between two clock reads
+  uint64_t Overhead = UINT64_MAX;
+  for (int i = 0; i < 10000; i++) {
+    BenchmarkClock::time_point StartTime = BenchmarkClock::now();
+    BenchmarkClock::time_point EndTime = BenchmarkClock::now();
+    uint64_t Elapsed = ElapsedNanoseconds(StartTime, EndTime);
+    if (Elapsed < Overhead) {
+      Overhead = Elapsed;
+    }
+  }
+  return Overhead;
+}
+
+static bool AllocationHooksWork() { // a malloc() and a new in a library object must both be counted
+  Allocations = 0;
+  AllocationCounting = true;
+  void *volatile Block = malloc(16);
+  std::vector<uint32_t> *volatile Vector = new std::vector<uint32_t>(4);
+  AllocationCounting = false;
+  free(Block);
+  delete Vector;
+  return (Allocations >= 3);
+}
+
+static uint64_t Percentile(const std::vector<uint64_t> &SortedTimes, unsigned int Percent) {
+  size_t Index = ((SortedTimes.size() * Percent) + 99) / 100;
+  if (Index > 0) {
+    Index--;
+  }
+  return SortedTimes[Index];
+}
+
+// off-grid frequency for precision frequency mode - the same for both searches
+static uint64_t PrecisionFrequency(uint64_t Frequency) {
+  uint32_t Offset = (uint32_t)((Frequency * 2654435761ULL) % PrecisionOffsetRange);
+  if ((Frequency + Offset) > GridStop) {
+    return (Frequency - Offset);
+  }
+  return (Frequency + Offset);
+}
+
+static BenchmarkResult RunBenchmark(uint8_t Benchmark, const char *Name, uint32_t GridStep, uint64_t Overhead, uint32_t Tolerance = 0) {
+  std::vector<uint64_t> Times;
+  Times.reserve((size_t)(((GridStop - GridStart) / GridStep) + 1));
+  unsigned long Errors = 0;
+  unsigned long Warnings = 0;
+  unsigned long RegistersWritten = 0;
+  unsigned long CallAllocations = 0;
+  uint64_t TotalTime = 0;
+  uint64_t MaximumTime = 0;
+  uint64_t WorstFrequency = 0;
+  uint64_t BusTime = 0;
+  uint64_t MaximumBusTime = 0;
+  char FrequencyString[12];
+  vfo.setf(GridStart, 4, 0, MAX2870_AUX_DIVIDED, false, 0, 0); // start from the same state for each benchmark
+  vfo.setPrecisionSearch((Benchmark == BenchmarkPrecisionLinear) ? MAX2870_PRECISION_SEARCH_LINEAR : MAX2870_PRECISION_SEARCH_RATIONAL);
+  for (uint64_t GridFrequency = GridStart; GridFrequency <= GridStop; GridFrequency += GridStep) {
+    uint64_t Frequency = GridFrequency;
+    if (Benchmark == BenchmarkChannelStepString) {
+      snprintf(FrequencyString, sizeof(FrequencyString), "%llu", (unsigned long long)Frequency); // not timed
+    }
+    else if (Benchmark == BenchmarkPrecision || Benchmark == BenchmarkPrecisionLinear) {
+      Frequency = PrecisionFrequency(GridFrequency); // not timed
+    }
+    int ErrorCode;
+    uint64_t BusStartTime = HostBus.Now;
+    Allocations = 0;
+    AllocationCounting = true;
+    BenchmarkClock::time_point StartTime = BenchmarkClock::now();
+    switch (Benchmark) {
+      case BenchmarkChannelStep:
+        ErrorCode = vfo.setf(Frequency, 4, 0, MAX2870_AUX_DIVIDED, false, 0, 0);
+        break;
+      case BenchmarkChannelStepString:
+        ErrorCode = vfo.setf(FrequencyString, 4, 0, MAX2870_AUX_DIVIDED, false, 0, 0);
+        break;
+      case BenchmarkPrecision:
+      case BenchmarkPrecisionLinear:
+        ErrorCode = vfo.setf(Frequency, 4, 0, MAX2870_AUX_DIVIDED, true, Tolerance, CalculationTimeout);
+        break;
+      case BenchmarkMilliHz:
+        ErrorCode = vfo.setfMilliHz((Frequency * 1000), 4, 0, MAX2870_AUX_DIVIDED, false, 0, 0);
+        break;
+      default:
+        ErrorCode = vfo.setfFast(Frequency);
+        break;
+    }
+    BenchmarkClock::time_point EndTime = BenchmarkClock::now();
+    AllocationCounting = false;
+    CallAllocations += Allocations;
+    uint64_t ElapsedTime = ElapsedNanoseconds(StartTime, EndTime);
+    ElapsedTime = ((ElapsedTime > Overhead) ? (ElapsedTime - Overhead) : 0);
+    uint64_t ElapsedBusTime = (HostBus.Now - BusStartTime);
+    BusTime += ElapsedBusTime;
+    if (ElapsedBusTime > MaximumBusTime) {
+      MaximumBusTime = ElapsedBusTime;
+    }
+    if (ErrorCode == MAX2870_WARNING_FREQUENCY_ERROR) {
+      Warnings++;
+    }
+    else if (ErrorCode != MAX2870_ERROR_NONE) {
+      Errors++;
+    }
+    RegistersWritten += vfo.MAX2870_RegsWrittenCount;
+    TotalTime += ElapsedTime;
+    if (ElapsedTime > MaximumTime) {
+      MaximumTime = ElapsedTime;
+      WorstFrequency = Frequency;
+    }
+    Times.push_back(ElapsedTime);
+  }
+  size_t Calls = Times.size();
+  std::sort(Times.begin(), Times.end());
+  printf("%s\n", Name);
+  printf("  Calls: %lu\n", (unsigned long)Calls);
+  printf("  Errors/warnings: %lu/%lu\n", Errors, Warnings);
+  printf("  Registers written per call: %.2f\n", ((double)RegistersWritten / Calls));
+  printf("  Allocations per call: %.2f\n", ((double)CallAllocations / Calls));
+  printf("  Minimum/mean/maximum (nS): %llu/%llu/%llu\n", (unsigned long long)Times.front(), (unsigned long long)(TotalTime / Calls), (unsigned long long)MaximumTime);
+  printf("  p50/p90/p99 (nS): %llu/%llu/%llu\n", (unsigned long long)Percentile(Times, 50), (unsigned long long)Percentile(Times, 90), (unsigned long long)Percentile(Times, 99));
+  printf("  Worst case frequency (Hz): %llu\n", (unsigned long long)WorstFrequency);
+  printf("  Simulated bus time mean/maximum (nS): %llu/%llu\n", (unsigned long long)(BusTime / Calls), (unsigned long long)MaximumBusTime);
+  vfo.setPrecisionSearch(MAX2870_PRECISION_SEARCH_RATIONAL);
+  BenchmarkResult Result;
+  Result.Mean = (TotalTime / Calls);
+  Result.P99 = Percentile(Times, 99);
+  return Result;
+}
+
+// Times[] holds the time of each call with its steps in Steps[]
+static void PrintSweepResults(const char *Name, std::vector<uint64_t> &Times, const std::vector<uint16_t> &Steps, unsigned long CallAllocations, int ErrorCode) {
+  uint64_t TotalTime = 0;
+  unsigned long TotalSteps = 0;
+  for (size_t i = 0; i < Times.size(); i++) {
+    TotalTime += Times[i];
+    TotalSteps += Steps[i];
+  }
+  std::sort(Times.begin(), Times.end());
+  printf("%s\n", Name);
+  printf("  Calls/steps: %lu/%lu\n", (unsigned long)Times.size(), TotalSteps);
+  printf("  Error code: %d\n", ErrorCode);
+  printf("  Allocations per step: %.2f\n", ((double)CallAllocations / TotalSteps));
+  printf("  Mean per step (nS): %.1f\n", ((double)TotalTime / TotalSteps));
+  printf("  Call minimum/p50/p99/maximum (nS): %llu/%llu/%llu/%llu\n", (unsigned long long)Times.front(), (unsigned long long)Percentile(Times, 50),
+         (unsigned long long)Percentile(Times, 99), (unsigned long long)Times.back());
+}
+
+static void RunSweepBenchmark(uint8_t Benchmark, const char *Name, uint32_t GridStep, uint64_t Overhead) {
+  std::vector<uint64_t> Times;
+  std::vector<uint16_t> Steps;
+  size_t GridSteps = (size_t)(((GridStop - GridStart) / GridStep) + 1);
+  Times.reserve(GridSteps + 1);
+  Steps.reserve(GridSteps + 1);
+  unsigned long CallAllocations = 0;
+  int ErrorCode = MAX2870_ERROR_NONE;
+  vfo.setf(GridStart, 4, 0, MAX2870_AUX_DIVIDED, false, 0, 0); // start from the same state for each benchmark
+  if (Benchmark == SweepBenchmarkService) {
+    ErrorCode = vfo.startSweep(GridStart, GridStop, GridStep, 0, false); // writes the first step
+    while (vfo.MAX2870_SweepRunning == true && ErrorCode == MAX2870_ERROR_NONE) {
+      uint32_t StepsBefore = vfo.MAX2870_SweepStepsWritten;
+      Allocations = 0;
+      AllocationCounting = true;
+      BenchmarkClock::time_point StartTime = BenchmarkClock::now();
+      ErrorCode = vfo.serviceSweep();
+      BenchmarkClock::time_point EndTime = BenchmarkClock::now();
+      AllocationCounting = false;
+      CallAllocations += Allocations;
+      uint64_t ElapsedTime = ElapsedNanoseconds(StartTime, EndTime);
+      Times.push_back((ElapsedTime > Overhead) ? (ElapsedTime - Overhead) : 0);
+      Steps.push_back((uint16_t)(vfo.MAX2870_SweepStepsWritten - StepsBefore));
+    }
+  }
+  else {
+    for (uint64_t BlockStart = GridStart; BlockStart <= GridStop; BlockStart += ((uint64_t)GridStep * SweepBlockSteps)) {
+      uint16_t StepsPlanned = 0;
+      Allocations = 0;
+      AllocationCounting = true;
+      BenchmarkClock::time_point StartTime = BenchmarkClock::now();
+      if (Benchmark == SweepBenchmarkPlan) {
+        ErrorCode = vfo.planSweep(BlockStart, GridStop, GridStep, SweepRegisters, SweepBlockSteps, &StepsPlanned);
+      }
+      else {
+        ErrorCode = vfo.planSweepCompact(BlockStart, GridStop, GridStep, SweepSteps, SweepBlockSteps, &StepsPlanned);
+      }
+      BenchmarkClock::time_point EndTime = BenchmarkClock::now();
+      AllocationCounting = false;
+      CallAllocations += Allocations;
+      uint64_t ElapsedTime = ElapsedNanoseconds(StartTime, EndTime);
+      Times.push_back((ElapsedTime > Overhead) ? (ElapsedTime - Overhead) : 0);
+      Steps.push_back(StepsPlanned);
+      if (ErrorCode != MAX2870_ERROR_NONE && ErrorCode != MAX2870_WARNING_FREQUENCY_ERROR) {
+        break;
+      }
+    }
+  }
+  PrintSweepResults(Name, Times, Steps, CallAllocations, ErrorCode);
+}
+
+int main(int argc, char *argv[]) {
+  uint32_t GridStep = GridStepDefault;
+  if (argc > 1) {
+    GridStep = strtoul(argv[1], NULL, 10);
+    if (GridStep == 0 || (GridStep % ChannelStep) != 0) {
+      printf("GridStep must be a multiple of %lu Hz\n", (unsigned long)ChannelStep);
+      return 1;
+    }
+  }
+  HostBus.reset();
+  HostBus.Logging = false;
+  vfo.init(SSpin, LockPin, false, CEpin, true);
+  vfo.setrf(ReferenceFrequency, ReferenceDivider, MAX2870_REF_UNDIVIDED);
+  vfo.SetStepFreq(ChannelStep);
+  if (AllocationHooksWork() == false) {
+    printf("Allocation hooks are not linked\n");
+    return 1;
+  }
+  uint64_t Overhead = TimerOverhead();
+  printf("Grid (Hz): %llu to %llu step %lu\n", (unsigned long long)GridStart, (unsigned long long)GridStop, (unsigned long)GridStep);
+  printf("Timer overhead subtracted (nS): %llu\n", (unsigned long long)Overhead);
+  RunBenchmark(BenchmarkChannelStep, "setf() channel step mode", GridStep, Overhead);
+  RunBenchmark(BenchmarkChannelStepString, "setf() channel step mode with frequency string", GridStep, Overhead);
+  RunBenchmark(BenchmarkMilliHz, "setfMilliHz() channel step mode", GridStep, Overhead);
+  BenchmarkResult LinearResults[PrecisionToleranceCount];
+  BenchmarkResult RationalResults[PrecisionToleranceCount];
+  for (int i = 0; i < PrecisionToleranceCount; i++) {
+    char Name[128];
+    snprintf(Name, sizeof(Name), "setf() precision frequency mode off the grid with %lu Hz tolerance - linear search (baseline)", (unsigned long)PrecisionTolerances[i]);
+    LinearResults[i] = RunBenchmark(BenchmarkPrecisionLinear, Name, GridStep, Overhead, PrecisionTolerances[i]);
+    snprintf(Name, sizeof(Name), "setf() precision frequency mode off the grid with %lu Hz tolerance - rational search", (unsigned long)PrecisionTolerances[i]);
+    RationalResults[i] = RunBenchmark(BenchmarkPrecision, Name, GridStep, Overhead, PrecisionTolerances[i]);
+  }
+  RunBenchmark(BenchmarkFast, "setfFast()", GridStep, Overhead);
+  RunSweepBenchmark(SweepBenchmarkPlan, "planSweep()", GridStep, Overhead);
+  RunSweepBenchmark(SweepBenchmarkPlanCompact, "planSweepCompact()", GridStep, Overhead);
+  RunSweepBenchmark(SweepBenchmarkService, "startSweep()/serviceSweep() with no dwell", GridStep, Overhead);
+  printf("Precision search (nS)\n");
+  printf("  Tolerance (Hz)  Linear mean/p99  Rational mean/p99  Mean speedup\n");
+  for (int i = 0; i < PrecisionToleranceCount; i++) {
+    char Linear[32];
+    char Rational[32];
+    snprintf(Linear, sizeof(Linear), "%llu/%llu", (unsigned long long)LinearResults[i].Mean, (unsigned long long)LinearResults[i].P99);
+    snprintf(Rational, sizeof(Rational), "%llu/%llu", (unsigned long long)RationalResults[i].Mean, (unsigned long long)RationalResults[i].P99);
+    printf("  %14lu  %15s  %17s  %11.1fx\n", (unsigned long)PrecisionTolerances[i], Linear, Rational,
+           ((double)LinearResults[i].Mean / ((RationalResults[i].Mean > 0) ? RationalResults[i].Mean : 1)));
+  }
+  printf("Benchmark complete\n");
+  return 0;
+}
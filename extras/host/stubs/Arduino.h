@@ -0,0 +1,66 @@
+/*!
+   @file Arduino.h
+
+   This is part of the host (Linux) build of the Arduino Library for the MAX2870 PLL wideband frequency synthesier
+
+   Stand-in for the Arduino core - pins and time are simulated and every pin change is recorded
+   in the bus log with the simulated time (see HostBus.h) - each pin is a port of its own with a bit
+   mask of 1 for transports which write the port registers
+
+*/
+
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+typedef uint8_t byte;
+typedef uint16_t word;
+typedef bool boolean;
+
+#define HIGH 0x1
+#define LOW 0x0
+#define INPUT 0x0
+#define OUTPUT 0x1
+#define INPUT_PULLUP 0x2
+#define LSBFIRST 0
+#define MSBFIRST 1
+
+#ifndef F_CPU
+#define F_CPU 16000000UL
+#endif
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t value);
+int digitalRead(uint8_t pin);
+
+class HostPort
+{
+  public:
+    HostPort &operator|=(int Mask); // sets the pin if bit 0 of Mask is set
+    HostPort &operator&=(int Mask); // clears the pin if bit 0 of Mask is clear
+    int operator&(int Mask) const; // reads the pin
+
+    uint8_t Pin;
+};
+
+uint8_t digitalPinToPort(uint8_t pin);
+uint8_t digitalPinToBitMask(uint8_t pin);
+HostPort *portOutputRegister(uint8_t port);
+HostPort *portInputRegister(uint8_t port);
+
+// 32 bit as on the Arduino cores so that wraparound behaves the same
+uint32_t micros();
+uint32_t millis();
+void delayMicroseconds(unsigned int us);
+void delay(unsigned long ms);
+
+void noInterrupts();
+void interrupts();
+
+#include "HostBus.h"
+
+#endif
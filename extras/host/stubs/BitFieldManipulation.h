@@ -0,0 +1,33 @@
+/*!
+   @file BitFieldManipulation.h
+
+   This is part of the host (Linux) build of the Arduino Library for the MAX2870 PLL wideband frequency synthesier
+
+   Stand-in for the BitFieldManipulation library - the library uses MAX2870Fields.h since v1.3.7 but sketches written
+   for earlier versions may still use it
+
+*/
+
+#ifndef HOST_BITFIELDMANIPULATION_H
+#define HOST_BITFIELDMANIPULATION_H
+#include <stdint.h>
+
+class BitFieldManipulationClass
+{
+  public:
+    uint32_t ReadBF_dword(uint8_t offset, uint8_t width, uint32_t value) {
+      return ((value >> offset) & Mask(width));
+    }
+    uint32_t WriteBF_dword(uint8_t offset, uint8_t width, uint32_t destination, uint32_t value) {
+      return ((destination & ~(Mask(width) << offset)) | ((value & Mask(width)) << offset));
+    }
+
+  private:
+    uint32_t Mask(uint8_t width) {
+      return (width >= 32 ? 0xFFFFFFFFUL : ((1UL << width) - 1));
+    }
+};
+
+extern BitFieldManipulationClass BitFieldManipulation;
+
+#endif
@@ -0,0 +1,92 @@
+/*!
+   @file HostBus.h
+
+   This is part of the host (Linux) build of the Arduino Library for the MAX2870 PLL wideband frequency synthesier
+
+   Simulated pins, clock and SPI bus behind the Arduino.h and SPI.h stand-ins.
+
+   Time is simulated in ns and only moves when the library does something which takes time on the Arduino -
+   a pin write (PinWriteTime) or port register write (PortWriteTime), a byte on the hardware SPI (8 clocks of the SPI clock), a delay() or
+   delayMicroseconds(), or a micros()/millis() call (PollTime, so that polling loops terminate).
+
+   Every pin change is logged with its time. Bits are shifted in on the rising edge of ClockPin (bit-bang)
+   or by SPI.transfer() while LatchPin is low, and the word is logged when LatchPin goes high - the last 32
+   bits shifted in are latched as on the MAX2870. After R6 has been latched with MUXOUT set to register
+   readback (MUX 1100) the next word shifted in shifts Readback out on ReadbackPin (read by the hardware SPI
+   when ReadbackPin is MISOPin), otherwise ReadbackPin reads high as an unconnected MUXOUT with the pull-up.
+
+*/
+
+#ifndef HOST_BUS_H
+#define HOST_BUS_H
+#include <stdint.h>
+#include <vector>
+
+#define HOST_PINS 64
+
+#define HOST_EVENT_PIN 0 // Level on Pin changed
+#define HOST_EVENT_WORD 1 // Word latched by the rising edge of the latch pin
+
+struct HostBusEvent
+{
+  uint64_t Time; // ns
+  uint8_t Type;
+  uint8_t Pin;
+  uint8_t Level;
+  uint32_t Word;
+};
+
+class HostBusClass
+{
+  public:
+    void reset(); // clears the log, pins and registers and restores the default timing - the time carries on
+    void advance(uint64_t ns);
+    std::vector<uint32_t> words() const; // latched words in the order they were written
+    std::vector<uint32_t> wordsSince(size_t Event) const; // latched words from Events[Event] on
+    uint64_t timeOfWord(size_t Word) const; // time the Word'th latched word was latched (ns)
+
+    // used by the stand-ins
+    void pinWrite(uint8_t Pin, uint8_t Level);
+    void portWrite(uint8_t Pin, uint8_t Level);
+    uint8_t pinRead(uint8_t Pin);
+    uint8_t spiTransfer(uint8_t Data);
+
+    uint64_t Now = 0; // simulated time (ns)
+    uint32_t SPIClock = 4000000UL; // SPI clock (Hz) of the current transaction
+    uint32_t PinWriteTime = 200; // time taken by digitalWrite() (ns)
+    uint32_t PortWriteTime = 125; // time taken by a read-modify-write of a port register (ns)
+    uint32_t PollTime = 1000; // time taken by each micros()/millis() call (ns)
+    bool Logging = true; // false to stop recording events (the registers are still latched)
+
+    uint8_t LatchPin = 10; // LE - the MAX2870 SS pin
+    uint8_t ClockPin = 13; // CLK for a bit-bang transport - the hardware SPI shifts bits without pin events
+    uint8_t DataPin = 11; // DATA for a bit-bang transport
+    uint8_t ReadbackPin = 12; // MUXOUT
+    uint8_t MISOPin = 12; // the hardware SPI reads MUXOUT when ReadbackPin is MISOPin
+
+    uint32_t Readback = 0x00000006; // R6 to shift out on MUXOUT
+    uint32_t Registers[7] {0, 0, 0, 0, 0, 0, 0}; // last word latched into each register
+    uint32_t WordsLatched = 0;
+
+    int InterruptsDisabled = 0; // noInterrupts() nesting depth - interrupts() should not take it below 0
+    uint32_t InterruptDisables = 0; // noInterrupts() calls
+    int InterruptErrors = 0; // interrupts() without a matching noInterrupts()
+
+    std::vector<HostBusEvent> Events;
+
+  private:
+    void writePin(uint8_t Pin, uint8_t Level, uint32_t WriteTime);
+    void shiftIn(uint8_t Bit);
+    void latch();
+    uint8_t readbackBit();
+
+    uint8_t Pins[HOST_PINS] {};
+    uint32_t Shift = 0;
+    uint8_t ShiftBits = 0; // bits shifted in since the latch pin went low
+    bool ReadbackArmed = false; // R6 has been latched with MUX 1100
+    bool ReadbackActive = false; // R6 is being shifted out
+};
+
+extern HostBusClass HostBus;
+
+#endif
@@ -0,0 +1,317 @@
+/*!
+   @file HostStubs.cpp
+
+   This is part of the host (Linux) build of the Arduino Library for the MAX2870 PLL wideband frequency synthesier
+
+   Arduino core, SPI and BitFieldManipulation stand-ins on the simulated bus (see HostBus.h)
+
+*/
+
+#include <Arduino.h>
+#include <SPI.h>
+#include <BitFieldManipulation.h>
+
+HostBusClass HostBus;
+SPIClass SPI;
+BitFieldManipulationClass BitFieldManipulation;
+
+void HostBusClass::reset()
+{
+  SPIClock = 4000000UL;
+  PinWriteTime = 200;
+  PortWriteTime = 125;
+  PollTime = 1000;
+  Logging = true;
+  LatchPin = 10;
+  ClockPin = 13;
+  DataPin = 11;
+  ReadbackPin = 12;
+  MISOPin = 12;
+  Readback = 0x00000006;
+  for (int i = 0; i < 7; i++) {
+    Registers[i] = 0;
+  }
+  WordsLatched = 0;
+  InterruptsDisabled = 0;
+  InterruptDisables = 0;
+  InterruptErrors = 0;
+  Events.clear();
+  for (int i = 0; i < HOST_PINS; i++) {
+    Pins[i] = LOW;
+  }
+  Pins[LatchPin] = HIGH;
+  Shift = 0;
+  ShiftBits = 0;
+  ReadbackArmed = false;
+  ReadbackActive = false;
+}
+
+void HostBusClass::advance(uint64_t ns)
+{
+  Now += ns;
+}
+
+std::vector<uint32_t> HostBusClass::words() const
+{
+  return wordsSince(0);
+}
+
+std::vector<uint32_t> HostBusClass::wordsSince(size_t Event) const
+{
+  std::vector<uint32_t> Words;
+  for (size_t i = Event; i < Events.size(); i++) {
+    if (Events[i].Type == HOST_EVENT_WORD) {
+      Words.push_back(Events[i].Word);
+    }
+  }
+  return Words;
+}
+
+uint64_t HostBusClass::timeOfWord(size_t Word) const
+{
+  for (size_t i = 0; i < Events.size(); i++) {
+    if (Events[i].Type == HOST_EVENT_WORD) {
+      if (Word == 0) {
+        return Events[i].Time;
+      }
+      Word--;
+    }
+  }
+  return 0;
+}
+
+void HostBusClass::pinWrite(uint8_t Pin, uint8_t Level)
+{
+  writePin(Pin, Level, PinWriteTime);
+}
+
+void HostBusClass::portWrite(uint8_t Pin, uint8_t Level)
+{
+  writePin(Pin, Level, PortWriteTime);
+}
+
+void HostBusClass::writePin(uint8_t Pin, uint8_t Level, uint32_t WriteTime)
+{
+  if (Pin >= HOST_PINS) {
+    return;
+  }
+  Level = (Level != LOW);
+  Now += WriteTime;
+  if (Pins[Pin] == Level) {
+    return;
+  }
+  Pins[Pin] = Level;
+  if (Logging) {
+    HostBusEvent Event = {Now, HOST_EVENT_PIN, Pin, Level, 0};
+    Events.push_back(Event);
+  }
+  if (Pin == LatchPin) {
+    if (Level == LOW) {
+      Shift = 0;
+      ShiftBits = 0;
+      ReadbackActive = ReadbackArmed;
+      ReadbackArmed = false;
+    }
+    else {
+      latch();
+    }
+  }
+  else if (Pin == ClockPin && Level == HIGH && Pins[LatchPin] == LOW) { // bit-bang - data is clocked in on the rising edge
+    shiftIn(Pins[DataPin]);
+  }
+}
+
+uint8_t HostBusClass::pinRead(uint8_t Pin)
+{
+  if (Pin >= HOST_PINS) {
+    return LOW;
+  }
+  if (Pin == ReadbackPin) {
+    return readbackBit();
+  }
+  return Pins[Pin];
+}
+
+uint8_t HostBusClass::spiTransfer(uint8_t Data)
+{
+  uint8_t Received = 0;
+  for (int k = 7; k >= 0; k--) {
+    if (Pins[LatchPin] == LOW) {
+      shiftIn((Data >> k) & 1);
+    }
+    Received = ((Received << 1) | ((ReadbackPin == MISOPin) ? readbackBit() : HIGH));
+  }
+  Now += ((8000000000ULL + SPIClock - 1) / SPIClock);
+  return Received;
+}
+
+void HostBusClass::shiftIn(uint8_t Bit)
+{
+  Shift = ((Shift << 1) | Bit);
+  if (ShiftBits < 0xFF) {
+    ShiftBits++;
+  }
+}
+
+void HostBusClass::latch()
+{
+  if (ShiftBits == 0) {
+    return;
+  }
+  uint8_t Address = (Shift & 0x07);
+  if (Address <= 6) {
+    Registers[Address] = Shift;
+  }
+  WordsLatched++;
+  if (Logging) {
+    HostBusEvent Event = {Now, HOST_EVENT_WORD, LatchPin, HIGH, Shift};
+    Events.push_back(Event);
+  }
+  bool MuxReadback = (((Registers[0x02] >> 26) & 0x07) == 0x04 && ((Registers[0x05] >> 18) & 0x01) == 1);
+  ReadbackArmed = (Address == 6 && MuxReadback);
+  ShiftBits = 0;
+}
+
+uint8_t HostBusClass::readbackBit()
+{
+  if (ReadbackActive == false) {
+    return HIGH; // pull-up
+  }
+  if (ShiftBits == 0 || ShiftBits > 32) {
+    return LOW;
+  }
+  return ((Readback >> (32 - ShiftBits)) & 1); // the bit for the clock edge just taken
+}
+
+void pinMode(uint8_t pin, uint8_t mode)
+{
+  (void)pin;
+  (void)mode;
+}
+
+void digitalWrite(uint8_t pin, uint8_t value)
+{
+  HostBus.pinWrite(pin, value);
+}
+
+int digitalRead(uint8_t pin)
+{
+  return HostBus.pinRead(pin);
+}
+
+static HostPort HostPorts[HOST_PINS];
+
+HostPort &HostPort::operator|=(int Mask)
+{
+  if ((Mask & 1) != 0) {
+    HostBus.portWrite(Pin, HIGH);
+  }
+  return *this;
+}
+
+HostPort &HostPort::operator&=(int Mask)
+{
+  if ((Mask & 1) == 0) {
+    HostBus.portWrite(Pin, LOW);
+  }
+  return *this;
+}
+
+int HostPort::operator&(int Mask) const
+{
+  return (HostBus.pinRead(Pin) & Mask);
+}
+
+uint8_t digitalPinToPort(uint8_t pin)
+{
+  return pin;
+}
+
+uint8_t digitalPinToBitMask(uint8_t pin)
+{
+  (void)pin;
+  return 1;
+}
+
+HostPort *portOutputRegister(uint8_t port)
+{
+  HostPorts[port].Pin = port;
+  return &HostPorts[port];
+}
+
+HostPort *portInputRegister(uint8_t port)
+{
+  return portOutputRegister(port);
+}
+
+uint32_t micros()
+{
+  HostBus.advance(HostBus.PollTime);
+  return (uint32_t)(HostBus.Now / 1000);
+}
+
+uint32_t millis()
+{
+  HostBus.advance(HostBus.PollTime);
+  return (uint32_t)(HostBus.Now / 1000000);
+}
+
+void delayMicroseconds(unsigned int us)
+{
+  HostBus.advance((uint64_t)us * 1000);
+}
+
+void delay(unsigned long ms)
+{
+  HostBus.advance((uint64_t)ms * 1000000);
+}
+
+void noInterrupts()
+{
+  HostBus.InterruptsDisabled++;
+  HostBus.InterruptDisables++;
+}
+
+void interrupts()
+{
+  if (HostBus.InterruptsDisabled == 0) {
+    HostBus.InterruptErrors++;
+    return;
+  }
+  HostBus.InterruptsDisabled--;
+}
+
+void SPIClass::begin()
+{
+}
+
+void SPIClass::end()
+{
+}
+
+void SPIClass::beginTransaction(SPISettings settings)
+{
+  HostBus.SPIClock = settings.Clock;
+}
+
+void SPIClass::endTransaction()
+{
+}
+
+uint8_t SPIClass::transfer(uint8_t data)
+{
+  return HostBus.spiTransfer(data);
+}
+
+void SPIClass::transfer(void *buf, size_t count)
+{
+  uint8_t *Buffer = (uint8_t *)buf;
+  for (size_t i = 0; i < count; i++) {
+    Buffer[i] = HostBus.spiTransfer(Buffer[i]);
+  }
+}
+
+void SPIClass::usingInterrupt(uint8_t interruptNumber)
+{
+  (void)interruptNumber;
+}
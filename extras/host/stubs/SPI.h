@@ -0,0 +1,45 @@
+/*!
+   @file SPI.h
+
+   This is part of the host (Linux) build of the Arduino Library for the MAX2870 PLL wideband frequency synthesier
+
+   Stand-in for the Arduino SPI library - each byte is shifted into the bus log (see HostBus.h) and takes
+   8 clocks of the transaction's SPI clock in simulated time
+
+*/
+
+#ifndef HOST_SPI_H
+#define HOST_SPI_H
+#include <Arduino.h>
+
+#define SPI_MODE0 0x00
+#define SPI_MODE1 0x04
+#define SPI_MODE2 0x08
+#define SPI_MODE3 0x0C
+
+class SPISettings
+{
+  public:
+    SPISettings() : Clock(4000000UL), BitOrder(MSBFIRST), DataMode(SPI_MODE0) {} // as the Arduino SPI library
+    SPISettings(uint32_t clock, uint8_t bitOrder, uint8_t dataMode) : Clock(clock), BitOrder(bitOrder), DataMode(dataMode) {}
+
+    uint32_t Clock;
+    uint8_t BitOrder;
+    uint8_t DataMode;
+};
+
+class SPIClass
+{
+  public:
+    void begin();
+    void end();
+    void beginTransaction(SPISettings settings);
+    void endTransaction();
+    uint8_t transfer(uint8_t data);
+    void transfer(void *buf, size_t count);
+    void usingInterrupt(uint8_t interruptNumber);
+};
+
+extern SPIClass SPI;
+
+#endif
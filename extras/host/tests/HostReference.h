@@ -0,0 +1,57 @@
+/*!
+   @file HostReference.h
+
+   This is part of the host (Linux) build of the Arduino Library for the MAX2870 PLL wideband frequency synthesier
+
+   Register decoding (independent of MAX2870Fields.h) and exact 128 bit frequency arithmetic for the host tests
+
+*/
+
+#ifndef HOST_REFERENCE_H
+#define HOST_REFERENCE_H
+#include <stdint.h>
+
+struct DecodedRegisters {
+  uint32_t N_Int;
+  uint32_t Frac;
+  uint32_t Mod;
+  uint32_t RfDivider;
+  uint32_t R;
+  bool Doubler;
+  bool Half;
+};
+
+static inline DecodedRegisters Decode(const uint32_t *regs) {
+  DecodedRegisters Decoded;
+  Decoded.N_Int = ((regs[0] >> 15) & 0xFFFF);
+  Decoded.Frac = ((regs[0] >> 3) & 0x0FFF);
+  Decoded.Mod = ((regs[1] >> 3) & 0x0FFF);
+  Decoded.RfDivider = (1UL << ((regs[4] >> 20) & 0x07));
+  Decoded.R = ((regs[2] >> 14) & 0x03FF);
+  Decoded.Doubler = (((regs[2] >> 25) & 1) != 0);
+  Decoded.Half = (((regs[2] >> 24) & 1) != 0);
+  return Decoded;
+}
+
+// RF output - requested in units of 1 / Scale Hz as Numerator / Denominator
+static inline void FrequencyOffset(const DecodedRegisters &Decoded, uint32_t ReferenceFrequency, uint64_t Requested, uint32_t Scale, __int128 &Numerator, __int128 &Denominator) {
+  __int128 PFDnumerator = (__int128)ReferenceFrequency * (Decoded.Doubler ? 2 : 1) * Scale;
+  __int128 PFDdenominator = (__int128)Decoded.R * (Decoded.Half ? 2 : 1);
+  Numerator = (PFDnumerator * (((__int128)Decoded.N_Int * Decoded.Mod) + Decoded.Frac));
+  Denominator = (PFDdenominator * Decoded.Mod * Decoded.RfDivider);
+  Numerator -= ((__int128)Requested * Denominator);
+}
+
+// exact frequency error in Hz rounded to the nearest Hz (halves away from 0)
+static inline int64_t ReferenceError(const DecodedRegisters &Decoded, uint32_t ReferenceFrequency, uint64_t Requested, uint32_t Scale) {
+  __int128 Numerator;
+  __int128 Denominator;
+  FrequencyOffset(Decoded, ReferenceFrequency, Requested, Scale, Numerator, Denominator);
+  Denominator *= Scale;
+  if (Numerator < 0) {
+    return -(int64_t)((((-Numerator) * 2) + Denominator) / (Denominator * 2));
+  }
+  return (int64_t)(((Numerator * 2) + Denominator) / (Denominator * 2));
+}
+
+#endif
@@ -0,0 +1,39 @@
+/*!
+   @file HostTest.h
+
+   This is part of the host (Linux) build of the Arduino Library for the MAX2870 PLL wideband frequency synthesier
+
+   Minimal test checks for the host tests - each test is an executable which returns non-zero when a check failed
+
+*/
+
+#ifndef HOST_TEST_H
+#define HOST_TEST_H
+#include <stdio.h>
+#include <inttypes.h>
+
+static int HostTestFailures = 0;
+
+#define HOST_CHECK(condition) \
+  do { \
+    if (!(condition)) { \
+      HostTestFailures++; \
+      printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+    } \
+  } while (0)
+
+#define HOST_CHECK_EQUAL(expected, actual) \
+  do { \
+    unsigned long long HostExpected = (unsigned long long)(expected); \
+    unsigned long long HostActual = (unsigned long long)(actual); \
+    if (HostExpected != HostActual) { \
+      HostTestFailures++; \
+      printf("%s:%d: %s == %s failed: expected 0x%llX (%llu) got 0x%llX (%llu)\n", __FILE__, __LINE__, #expected, #actual, \
+             HostExpected, HostExpected, HostActual, HostActual); \
+    } \
+  } while (0)
+
+#define HOST_TEST_RESULT() \
+  ((HostTestFailures == 0) ? (printf("passed\n"), 0) : (printf("%d checks failed\n", HostTestFailures), 1))
+
+#endif
@@ -0,0 +1,77 @@
+/*!
+   @file MAX2870RecordingTransport.h
+
+   This is part of the host (Linux) build of the Arduino Library for the MAX2870 PLL wideband frequency synthesier
+
+   A transport for MAX2870Device<Transport> which records register words instead of sending them
+
+*/
+
+#ifndef MAX2870RECORDINGTRANSPORT_H
+#define MAX2870RECORDINGTRANSPORT_H
+#include <MAX2870.h>
+
+/*!
+   @brief records register words instead of sending them for verification without a MAX2870 or the simulated bus
+
+   read() emulates register readback - StatusRegister is returned with the VCO band (V) of the last written R3
+   when the VAS state machine is disabled, or all ones as from an unconnected MUXOUT when MUXOUT has not been set to register readback
+*/
+class MAX2870RecordingTransport
+{
+  public:
+    MAX2870RecordingTransport(uint32_t *Words, uint16_t Size) : RecordedWords(Words), RecordedSize(Size) {}
+
+    void begin(uint8_t /* SSpin */) {
+      clear();
+    }
+
+    void write(const uint8_t *Buffer, uint8_t Registers) {
+      for (int i = 0; i < Registers; i++) {
+        uint32_t value = 0;
+        for (int j = 0; j < 4; j++) {
+          value <<= 8;
+          value |= Buffer[(i * 4) + j];
+        }
+        if (RecordedCount < RecordedSize) {
+          RecordedWords[RecordedCount] = value;
+          RecordedCount++;
+        }
+        if ((value & 0x07) < 6) {
+          RegisterWords[(value & 0x07)] = value;
+        }
+        WordsWritten++;
+      }
+      Writes++;
+    }
+
+    bool read(uint32_t *Value) {
+      Reads++;
+      if (MAX2870Field_MUX::Get(RegisterWords[0x02]) != 0x04 || MAX2870Field_MUX_MSB::Get(RegisterWords[0x05]) != 1) { // MUX is not 1100
+        *Value = 0xFFFFFFFF;
+        return true;
+      }
+      *Value = StatusRegister;
+      if (MAX2870Field_VAS_SHDN::Get(RegisterWords[0x03]) == 1) {
+        *Value = MAX2870Field_V::Set(*Value, MAX2870Field_VCO::Get(RegisterWords[0x03]));
+      }
+      return true;
+    }
+
+    void clear() {
+      RecordedCount = 0;
+      WordsWritten = 0;
+      Writes = 0;
+    }
+
+    uint32_t *RecordedWords; // words are recorded in the order they would have been written
+    uint16_t RecordedSize;
+    uint16_t RecordedCount = 0; // words recorded - no more than RecordedSize
+    uint32_t WordsWritten = 0; // including words which did not fit into RecordedWords
+    uint32_t Writes = 0; // number of write() calls
+    uint32_t RegisterWords[6] {0, 0, 0, 0, 0, 0}; // last word written to each register
+    uint32_t StatusRegister = 0x00000006; // R6 returned by read()
+    uint32_t Reads = 0;
+};
+
+#endif
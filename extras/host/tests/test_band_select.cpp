@@ -0,0 +1,43 @@
+/*!
+   @file test_band_select.cpp
+
+   This is part of the host (Linux) build of the Arduino Library for the MAX2870 PLL wideband frequency synthesier
+
+   Checks that setrf()/setf() set the band select clock divider (R4 BS) to PFD / MAX2870_BAND_SELECT_CLOCK_MAX rounded up for
+   the band select clock latched on the bus, and that a PFD above 1023 * 50 kHz clamps it to 1023 and latches
+   MAX2870_WARNING_FLAG_BAND_SELECT_CLAMPED for readWarnings() instead of clamping silently
+
+*/
+
+#include <MAX2870.h>
+#include "HostTest.h"
+
+static uint32_t BandSelectDivider(const uint32_t *regs) {
+  return (MAX2870Field_BS::Read(regs) | (MAX2870Field_BS_MSB::Read(regs) << 8));
+}
+
+static void TestDivider(uint32_t ReferenceFrequency, uint16_t R, uint8_t ReferenceDivisionType, uint32_t PFD, uint64_t Frequency, bool Clamped) {
+  HostBus.reset();
+  MAX2870 vfo;
+  vfo.init(10, 8, false, 9, false);
+  HOST_CHECK_EQUAL(MAX2870_ERROR_NONE, vfo.setrf(ReferenceFrequency, R, ReferenceDivisionType));
+  HOST_CHECK_EQUAL(MAX2870_ERROR_NONE, vfo.SetStepFreq(500000UL)); // Frequency is a multiple of the PFD for integer-N
+  HOST_CHECK_EQUAL(MAX2870_ERROR_NONE, vfo.setf(Frequency, 4, 0, MAX2870_AUX_DIVIDED, false, 0, 0));
+  uint32_t Expected = ((PFD + MAX2870_BAND_SELECT_CLOCK_MAX - 1) / MAX2870_BAND_SELECT_CLOCK_MAX);
+  if (Clamped == true) {
+    HOST_CHECK(Expected > 1023);
+    Expected = 1023;
+  }
+  HOST_CHECK_EQUAL(Expected, BandSelectDivider(HostBus.Registers));
+  HOST_CHECK_EQUAL((Clamped == true ? MAX2870_WARNING_FLAG_BAND_SELECT_CLAMPED : 0), vfo.readWarnings());
+  HOST_CHECK_EQUAL(0, vfo.readWarnings()); // cleared when read
+}
+
+int main() {
+  TestDivider(10000000UL, 1, MAX2870_REF_UNDIVIDED, 10000000UL, 4000000000ULL, false);
+  TestDivider(25000000UL, 2, MAX2870_REF_UNDIVIDED, 12500000UL, 4000000000ULL, false);
+  TestDivider(30000000UL, 1, MAX2870_REF_DOUBLE, 60000000UL, 3600000000ULL, true);
+  TestDivider(100000000UL, 1, MAX2870_REF_UNDIVIDED, 100000000UL, 4000000000ULL, true);
+  TestDivider(100000000UL, 2, MAX2870_REF_UNDIVIDED, 50000000UL, 4000000000ULL, false);
+  return HOST_TEST_RESULT();
+}
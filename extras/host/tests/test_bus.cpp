@@ -0,0 +1,141 @@
+/*!
+   @file test_bus.cpp
+
+   This is part of the host (Linux) build of the Arduino Library for the MAX2870 PLL wideband frequency synthesier
+
+   Checks that the words latched on the simulated bus are the registers written by the library for the hardware SPI
+   (register and burst write modes) and the bit-bang and port transports, that R6 is read back from MUXOUT and that
+   the recording transport records the words written
+
+*/
+
+#include <MAX2870.h>
+#include "HostTest.h"
+#include "MAX2870RecordingTransport.h"
+
+template <class Device>
+static void CheckWrittenRegisters(Device &vfo, const std::vector<uint32_t> &Words)
+{
+  HOST_CHECK_EQUAL(6, Words.size());
+  for (size_t i = 0; i < Words.size() && i < 6; i++) { // R5 to R0
+    HOST_CHECK_EQUAL(vfo.MAX2870_R[(5 - i)], Words[i]);
+  }
+}
+
+static void TestHardwareSPI()
+{
+  HostBus.reset();
+  MAX2870 vfo;
+  vfo.init(10, 12, false, 0, false);
+  HOST_CHECK_EQUAL(MAX2870_ERROR_NONE, vfo.setf((uint64_t)1000000000ULL, 4, 0, MAX2870_AUX_DIVIDED, false, 0, 0));
+  CheckWrittenRegisters(vfo, HostBus.words());
+
+  // each word is latched by its own SS pulse with the SS edges in time order
+  size_t Falling = 0;
+  size_t Rising = 0;
+  uint64_t Previous = 0;
+  for (size_t i = 0; i < HostBus.Events.size(); i++) {
+    const HostBusEvent &Event = HostBus.Events[i];
+    HOST_CHECK(Event.Time >= Previous);
+    Previous = Event.Time;
+    if (Event.Type == HOST_EVENT_PIN && Event.Pin == 10) {
+      if (Event.Level == LOW) {
+        Falling++;
+      }
+      else {
+        Rising++;
+      }
+    }
+  }
+  HOST_CHECK_EQUAL(6, Falling);
+  HOST_CHECK_EQUAL(6, Rising);
+  HOST_CHECK(HostBus.timeOfWord(5) > HostBus.timeOfWord(0));
+
+  // at least 32 SPI clocks for each word at no more than the 10 MHz of the MAX2870
+  HostBus.reset();
+  uint64_t Start = HostBus.Now;
+  vfo.WriteAllRegs();
+  HOST_CHECK(HostBus.Now - Start >= (6 * 3200ULL));
+
+  HostBus.reset();
+  HOST_CHECK_EQUAL(MAX2870_ERROR_NONE, vfo.setWriteMode(MAX2870_WRITE_MODE_BURST));
+  vfo.WriteAllRegs();
+  CheckWrittenRegisters(vfo, HostBus.words());
+}
+
+// returns the simulated time taken by WriteAllRegs() (ns)
+template <class Transport>
+static uint64_t TestPinTransport(const Transport &RegisterTransport)
+{
+  HostBus.reset();
+  HostBus.LatchPin = 5;
+  HostBus.ClockPin = 6;
+  HostBus.DataPin = 7;
+  HostBus.ReadbackPin = 8;
+  HostBus.Readback = 0x12345676;
+  MAX2870Device<Transport> vfo(RegisterTransport);
+  vfo.init(5, 12, false, 0, false);
+  HOST_CHECK_EQUAL(MAX2870_ERROR_NONE, vfo.setf((uint64_t)2400000000ULL, 4, 0, MAX2870_AUX_DIVIDED, false, 0, 0));
+  CheckWrittenRegisters(vfo, HostBus.words());
+  HOST_CHECK_EQUAL(MAX2870_ERROR_NONE, vfo.setWriteMode(MAX2870_WRITE_MODE_BURST));
+  size_t Event = HostBus.Events.size();
+  uint64_t Start = HostBus.Now;
+  vfo.WriteAllRegs();
+  uint64_t WriteTime = (HostBus.Now - Start);
+  CheckWrittenRegisters(vfo, HostBus.wordsSince(Event));
+
+  MAX2870Status Status;
+  HOST_CHECK_EQUAL(MAX2870_ERROR_NONE, vfo.readStatusRegister(&Status));
+  HOST_CHECK_EQUAL(0x12345676, Status.Register);
+  for (int i = 0; i < 6; i++) { // MUXOUT is restored
+    HOST_CHECK_EQUAL(vfo.MAX2870_R[i], HostBus.Registers[i]);
+  }
+  return WriteTime;
+}
+
+static void TestRecording()
+{
+  HostBus.reset();
+  uint32_t Words[8];
+  MAX2870Device<MAX2870RecordingTransport> vfo(MAX2870RecordingTransport(Words, 8));
+  vfo.init(10, 12, false, 0, false);
+  HOST_CHECK_EQUAL(MAX2870_ERROR_NONE, vfo.setWriteMode(MAX2870_WRITE_MODE_BURST));
+  HOST_CHECK_EQUAL(MAX2870_ERROR_NONE, vfo.setf((uint64_t)1000000000ULL, 4, 0, MAX2870_AUX_DIVIDED, false, 0, 0));
+  HOST_CHECK_EQUAL(0, HostBus.WordsLatched); // nothing is sent on the bus
+  HOST_CHECK_EQUAL(1, vfo.MAX2870_Transport.Writes);
+  HOST_CHECK_EQUAL(6, vfo.MAX2870_Transport.RecordedCount);
+  CheckWrittenRegisters(vfo, std::vector<uint32_t>(Words, (Words + 6)));
+
+  MAX2870Status Status;
+  vfo.MAX2870_Transport.StatusRegister = 0x00000016;
+  HOST_CHECK_EQUAL(MAX2870_ERROR_NONE, vfo.readStatusRegister(&Status));
+  HOST_CHECK_EQUAL(0x00000016, Status.Register);
+  HOST_CHECK_EQUAL(1, vfo.MAX2870_Transport.Reads);
+}
+
+static void TestReadback()
+{
+  HostBus.reset();
+  HostBus.Readback = 0x8000004E;
+  MAX2870 vfo;
+  vfo.init(10, 8, false, 0, false);
+  HOST_CHECK_EQUAL(MAX2870_ERROR_NONE, vfo.setf((uint64_t)3000000000ULL, 4, 0, MAX2870_AUX_DIVIDED, false, 0, 0));
+  MAX2870Status Status;
+  HOST_CHECK_EQUAL(MAX2870_ERROR_NONE, vfo.readStatusRegister(&Status));
+  HOST_CHECK_EQUAL(0x8000004E, Status.Register);
+
+  HostBus.ReadbackPin = 9; // MUXOUT not connected to MISO
+  HOST_CHECK_EQUAL(MAX2870_ERROR_READBACK, vfo.readStatusRegister(&Status));
+}
+
+int main()
+{
+  TestHardwareSPI();
+  uint64_t BitBangTime = TestPinTransport(MAX2870BitBangTransport(6, 7, 8));
+  uint64_t PortTime = TestPinTransport(MAX2870PortTransport(6, 7, 8));
+  printf("WriteAllRegs(): bit-bang transport %lu nS, port transport %lu nS\n", (unsigned long)BitBangTime, (unsigned long)PortTime);
+  HOST_CHECK(PortTime < BitBangTime);
+  TestReadback();
+  TestRecording();
+  return HOST_TEST_RESULT();
+}
@@ -0,0 +1,121 @@
+/*!
+   @file test_constexpr.cpp
+
+   This is part of the host (Linux) build of the Arduino Library for the MAX2870 PLL wideband frequency synthesier
+
+   Checks MAX2870ConstPlan (MAX2870Constexpr.h) against setrf()/setf() in channel step mode from the power on defaults -
+   Error(), FrequencyError() and all six registers must be the same as the error code, ReadFrequencyError() and the
+   registers latched on the bus for reference configurations and random frequencies (including inexact 1 Hz steps and
+   invalid plans), and the README.md example must be a constant expression
+
+*/
+
+#include <MAX2870.h>
+#include <MAX2870Constexpr.h>
+#include "HostTest.h"
+
+// the README.md example is calculated by the compiler
+constexpr MAX2870ConstPlan LO(10000000UL, 1, MAX2870_REF_UNDIVIDED, 100000UL, 4007500000ULL, 4, 0, MAX2870_AUX_DIVIDED);
+static_assert(LO.Error() == MAX2870_ERROR_NONE, "LO frequency cannot be set");
+constexpr uint32_t LORegisters[MAX2870_RegsToWrite] = MAX2870_CONST_REGISTERS(LO);
+constexpr MAX2870ConstPlan Inexact(10000000UL, 1, MAX2870_REF_UNDIVIDED, 1UL, 5999999999ULL, 4, 0, MAX2870_AUX_DIVIDED);
+static_assert(Inexact.Error() == MAX2870_ERROR_NONE && Inexact.FrequencyError() != 0, "1 Hz steps beyond MOD 4095 are inexact");
+constexpr MAX2870ConstPlan OffGrid(10000000UL, 1, MAX2870_REF_UNDIVIDED, 100000UL, 4007550000ULL, 4, 0, MAX2870_AUX_DIVIDED);
+static_assert(OffGrid.Error() == MAX2870_ERROR_RF_FREQUENCY_AND_STEP_FREQUENCY_HAS_REMAINDER, "4007.55 MHz is not on the 100 kHz grid");
+
+struct ReferenceCase {
+  uint32_t ReferenceFrequency;
+  uint16_t R;
+  uint8_t ReferenceDivisionType;
+  uint32_t ChannelStep;
+};
+
+const ReferenceCase Cases[] = {
+  {10000000UL, 1, MAX2870_REF_UNDIVIDED, 100000UL},
+  {10000000UL, 1, MAX2870_REF_UNDIVIDED, 12500UL},
+  {25000000UL, 1, MAX2870_REF_UNDIVIDED, 25000UL},
+  {10000000UL, 1, MAX2870_REF_DOUBLE, 10000UL},
+  {100000000UL, 4, MAX2870_REF_HALF, 12500UL},
+  {122880000UL, 3, MAX2870_REF_UNDIVIDED, 10240UL}, // PFD above 32 MHz - lock detect speed
+  {10000000UL, 1, MAX2870_REF_UNDIVIDED, 1UL}, // MOD beyond 4095 - closest FRAC/MOD
+  {19200000UL, 1, MAX2870_REF_UNDIVIDED, 1UL},
+  {30000000UL, 3, MAX2870_REF_UNDIVIDED, 10UL},
+  {10000000UL, 1, MAX2870_REF_UNDIVIDED, 30000UL}, // PFD is not a multiple of the step - every plan is an error
+};
+
+static bool Compare(const MAX2870ConstPlan &Plan) {
+  HostBus.reset();
+  HostBus.Logging = false;
+  MAX2870 vfo;
+  vfo.init(10, 8, false, 9, false);
+  int ErrorCode = vfo.setrf(Plan.ReferenceFrequency, Plan.ReferenceDivider, Plan.ReferenceDivisionType);
+  if (ErrorCode == MAX2870_ERROR_NONE) {
+    ErrorCode = vfo.SetStepFreq(Plan.ChannelStep);
+  }
+  if (ErrorCode == MAX2870_ERROR_NONE) {
+    ErrorCode = vfo.setf(Plan.Frequency, Plan.PowerLevel, Plan.AuxPowerLevel, Plan.AuxFrequencyDivider, false, 0, 0);
+  }
+  int ExpectedCode = ((Plan.Error() == MAX2870_ERROR_NONE && Plan.FrequencyError() != 0) ? MAX2870_WARNING_FREQUENCY_ERROR : Plan.Error());
+  bool Match = (ErrorCode == ExpectedCode);
+  if (Match && Plan.Error() == MAX2870_ERROR_NONE) {
+    Match = (vfo.ReadFrequencyError() == Plan.FrequencyError());
+    for (uint8_t i = 0; i < MAX2870_RegsToWrite; i++) {
+      if (HostBus.Registers[i] != Plan.Register(i) || vfo.MAX2870_R[i] != Plan.Register(i)) {
+        printf("  R%u: latched %08lX plan %08lX\n", i, (unsigned long)HostBus.Registers[i], (unsigned long)Plan.Register(i));
+        Match = false;
+      }
+    }
+  }
+  if (Match == false) {
+    printf("%llu Hz (reference %lu Hz/%u step %lu Hz): error code %d plan %d frequency error %ld plan %ld\n", (unsigned long long)Plan.Frequency,
+           (unsigned long)Plan.ReferenceFrequency, Plan.ReferenceDivider, (unsigned long)Plan.ChannelStep, ErrorCode, Plan.Error(),
+           (long)vfo.ReadFrequencyError(), (long)Plan.FrequencyError());
+  }
+  return Match;
+}
+
+int main() {
+  HOST_CHECK(Compare(LO));
+  HOST_CHECK(Compare(Inexact));
+  HOST_CHECK(Compare(OffGrid));
+  HostBus.reset();
+  MAX2870 vfo;
+  vfo.init(10, 8, false, 9, false);
+  vfo.setrf(10000000UL, 1, MAX2870_REF_UNDIVIDED);
+  vfo.SetStepFreq(100000UL);
+  vfo.setf((uint64_t)4007500000ULL, 4, 0, MAX2870_AUX_DIVIDED, false, 0, 0);
+  for (int i = 0; i < (int)MAX2870_RegsToWrite; i++) {
+    HOST_CHECK_EQUAL(vfo.MAX2870_R[i], LORegisters[i]);
+  }
+
+  uint64_t State = 1;
+  for (size_t i = 0; i < (sizeof(Cases) / sizeof(Cases[0])); i++) {
+    const ReferenceCase &Case = Cases[i];
+    unsigned long Failures = 0;
+    unsigned long Warnings = 0;
+    unsigned long Errors = 0;
+    for (int j = 0; j < 2000 && Failures < 10; j++) {
+      State = (State * 6364136223846793005ULL) + 1442695040888963407ULL;
+      uint64_t Frequency = 23437500ULL + ((State >> 16) % (6000000000ULL - 23437500ULL));
+      if ((j % 16) != 0) { // mostly on the channel grid
+        Frequency -= (Frequency % Case.ChannelStep);
+      }
+      uint8_t PowerLevel = ((State >> 8) % 5);
+      uint8_t AuxPowerLevel = ((State >> 11) % 5);
+      uint8_t AuxFrequencyDivider = (((State >> 14) & 1) ? MAX2870_AUX_FUNDAMENTAL : MAX2870_AUX_DIVIDED);
+      MAX2870ConstPlan Plan(Case.ReferenceFrequency, Case.R, Case.ReferenceDivisionType, Case.ChannelStep, Frequency, PowerLevel, AuxPowerLevel, AuxFrequencyDivider);
+      if (Compare(Plan) == false) {
+        Failures++;
+      }
+      if (Plan.Error() != MAX2870_ERROR_NONE) {
+        Errors++;
+      }
+      else if (Plan.FrequencyError() != 0) {
+        Warnings++;
+      }
+    }
+    HOST_CHECK_EQUAL(0, Failures);
+    printf("reference %lu Hz/%u step %lu Hz: %lu errors %lu inexact\n", (unsigned long)Case.ReferenceFrequency, Case.R, (unsigned long)Case.ChannelStep, Errors, Warnings);
+  }
+  return HOST_TEST_RESULT();
+}
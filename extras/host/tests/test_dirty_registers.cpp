@@ -0,0 +1,138 @@
+/*!
+   @file test_dirty_registers.cpp
+
+   This is part of the host (Linux) build of the Arduino Library for the MAX2870 PLL wideband frequency synthesier
+
+   Checks that WriteRegs() writes only the registers which have changed (R5 to R1 in order) and R0 last when R0 or a field
+   which is latched by R0 (MOD, R counter/RDIV2/doubler, VCO selection/VAS, RF divider) has changed - the expected words are
+   from the last words latched on the bus and the register values after each call, for the register and burst write modes
+   and the pin transports
+
+*/
+
+#include <MAX2870.h>
+#include "HostTest.h"
+
+// fields which take effect when R0 is written (from the MAX2870 datasheet)
+const uint32_t LatchedByR0[6] = {0x00000000, 0x00007FF8, 0x03FFC000, 0xFE000000, 0x00700000, 0x00000000};
+
+static std::vector<uint32_t> ExpectedWords(const uint32_t *Previous, const uint32_t *Current, bool AllRegisters) {
+  std::vector<uint32_t> Words;
+  bool R0Required = (AllRegisters || Current[0] != Previous[0]);
+  for (int i = 5; i >= 1; i--) {
+    if (AllRegisters || Current[i] != Previous[i]) {
+      Words.push_back(Current[i]);
+    }
+    if (((Current[i] ^ Previous[i]) & LatchedByR0[i]) != 0) {
+      R0Required = true;
+    }
+  }
+  if (R0Required) {
+    Words.push_back(Current[0]);
+  }
+  return Words;
+}
+
+template <class Device>
+class DirtyRegisterCheck {
+  public:
+    DirtyRegisterCheck(Device &Synthesiser) : vfo(Synthesiser) {
+      for (int i = 0; i < 6; i++) {
+        Previous[i] = HostBus.Registers[i];
+      }
+      Event = HostBus.Events.size();
+    }
+
+    // call after each function which writes registers
+    void check(const char *Name, bool AllRegisters = false) {
+      std::vector<uint32_t> Expected = ExpectedWords(Previous, vfo.MAX2870_R, AllRegisters);
+      std::vector<uint32_t> Words = HostBus.wordsSince(Event);
+      bool Match = (Words == Expected && vfo.MAX2870_RegsWrittenCount == Expected.size());
+      if (Match == false) {
+        printf("%s: %lu words written (count %u) - %lu expected\n", Name, (unsigned long)Words.size(), vfo.MAX2870_RegsWrittenCount, (unsigned long)Expected.size());
+      }
+      HOST_CHECK(Match);
+      Histogram[Expected.size()]++;
+      for (int i = 0; i < 6; i++) {
+        Previous[i] = HostBus.Registers[i];
+      }
+      Event = HostBus.Events.size();
+    }
+
+    unsigned long Histogram[7] {0, 0, 0, 0, 0, 0, 0};
+
+  private:
+    Device &vfo;
+    uint32_t Previous[6];
+    size_t Event;
+};
+
+template <class Transport>
+static void TestWriteMode(uint8_t WriteMode, const Transport &RegisterTransport, const char *TransportName) {
+  HostBus.reset();
+  MAX2870Device<Transport> vfo(RegisterTransport);
+  vfo.init(10, 8, false, 9, false);
+  HOST_CHECK_EQUAL(MAX2870_ERROR_NONE, vfo.setWriteMode(WriteMode));
+  DirtyRegisterCheck<MAX2870Device<Transport> > Check(vfo);
+
+  HOST_CHECK_EQUAL(MAX2870_ERROR_NONE, vfo.setf((uint64_t)1000100000ULL, 4, 0, MAX2870_AUX_DIVIDED, false, 0, 0));
+  Check.check("first setf()", true);
+  HOST_CHECK_EQUAL(6, vfo.MAX2870_RegsWrittenCount);
+  HOST_CHECK_EQUAL(MAX2870_ERROR_NONE, vfo.setf((uint64_t)1000100000ULL, 4, 0, MAX2870_AUX_DIVIDED, false, 0, 0));
+  Check.check("same setf()");
+  HOST_CHECK_EQUAL(0, vfo.MAX2870_RegsWrittenCount);
+  HOST_CHECK_EQUAL(MAX2870_ERROR_NONE, vfo.setf((uint64_t)1000300000ULL, 4, 0, MAX2870_AUX_DIVIDED, false, 0, 0));
+  Check.check("setf() with the same MOD and RF divider");
+  HOST_CHECK_EQUAL(1, vfo.MAX2870_RegsWrittenCount);
+  HOST_CHECK_EQUAL(MAX2870_ERROR_NONE, vfo.setf((uint64_t)1000500000ULL, 4, 0, MAX2870_AUX_DIVIDED, false, 0, 0));
+  Check.check("setf() with a new MOD");
+  HOST_CHECK_EQUAL(2, vfo.MAX2870_RegsWrittenCount);
+  HOST_CHECK_EQUAL(MAX2870_ERROR_NONE, vfo.setPowerLevel(2));
+  Check.check("setPowerLevel()");
+  HOST_CHECK_EQUAL(1, vfo.MAX2870_RegsWrittenCount);
+  HOST_CHECK_EQUAL(MAX2870_ERROR_NONE, vfo.setAuxPowerLevel(3));
+  Check.check("setAuxPowerLevel()");
+  HOST_CHECK_EQUAL(1, vfo.MAX2870_RegsWrittenCount);
+  HOST_CHECK_EQUAL(MAX2870_ERROR_NONE, vfo.setCPcurrent(1.28));
+  Check.check("setCPcurrent()");
+  HOST_CHECK_EQUAL(1, vfo.MAX2870_RegsWrittenCount);
+  HOST_CHECK_EQUAL(MAX2870_ERROR_NONE, vfo.setrf(20000000UL, 2, MAX2870_REF_UNDIVIDED));
+  HOST_CHECK_EQUAL(MAX2870_ERROR_NONE, vfo.setf((uint64_t)1000500000ULL, 4, 0, MAX2870_AUX_DIVIDED, false, 0, 0));
+  Check.check("setf() after setrf() with the same PFD");
+  vfo.WriteAllRegs();
+  Check.check("WriteAllRegs()", true);
+  HOST_CHECK_EQUAL(6, vfo.MAX2870_RegsWrittenCount);
+
+  // random retunes across every RF divider band and power level changes
+  uint64_t State = (WriteMode + 1);
+  for (int i = 0; i < 3000; i++) {
+    State = (State * 6364136223846793005ULL) + 1442695040888963407ULL;
+    uint32_t Action = (uint32_t)(State >> 33);
+    if ((Action % 8) == 0) {
+      HOST_CHECK_EQUAL(MAX2870_ERROR_NONE, vfo.setPowerLevel((Action >> 3) % 5));
+      Check.check("random setPowerLevel()");
+    }
+    else {
+      uint64_t Frequency = 23500000ULL + (((uint64_t)Action * 100000ULL) % (6000000000ULL - 23500000ULL));
+      Frequency -= (Frequency % 100000ULL);
+      if ((Action % 8) == 1) { // nearby channel
+        Frequency = 2400000000ULL + (((Action >> 3) % 64) * 100000ULL);
+      }
+      HOST_CHECK_EQUAL(MAX2870_ERROR_NONE, vfo.setf(Frequency, 4, 0, MAX2870_AUX_DIVIDED, false, 0, 0));
+      Check.check("random setf()");
+    }
+  }
+  printf("write mode %u with the %s - registers written per call:", WriteMode, TransportName);
+  for (int i = 0; i <= 6; i++) {
+    printf(" %d: %lu", i, Check.Histogram[i]);
+  }
+  printf("\n");
+}
+
+int main() {
+  TestWriteMode(MAX2870_WRITE_MODE_REGISTER, MAX2870HardwareSPI(), "hardware SPI");
+  TestWriteMode(MAX2870_WRITE_MODE_BURST, MAX2870HardwareSPI(), "hardware SPI");
+  TestWriteMode(MAX2870_WRITE_MODE_REGISTER, MAX2870BitBangTransport(13, 11), "bit-bang transport");
+  TestWriteMode(MAX2870_WRITE_MODE_BURST, MAX2870PortTransport(13, 11), "port transport");
+  return HOST_TEST_RESULT();
+}
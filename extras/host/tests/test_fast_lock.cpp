@@ -0,0 +1,93 @@
+/*!
+   @file test_fast_lock.cpp
+
+   This is part of the host (Linux) build of the Arduino Library for the MAX2870 PLL wideband frequency synthesier
+
+   Checks the MAX2870_FAST_LOCK_HARDWARE clock divider - the fast lock lasts MOD * CDIV / PFD, so the CDIV latched on
+   the bus with each frequency (setf(), setfFast(), setfDirect() and random frequencies with every MOD) must be the
+   smallest which lasts for no less than the timeout, and setFastLock() must check the timeout against the current MOD -
+   MAX2870_FAST_LOCK_SOFTWARE must be refused with MAX2870_WRITE_MODE_QUEUE
+
+*/
+
+#include <MAX2870.h>
+#include "HostTest.h"
+
+const uint32_t ReferenceFrequency = 10000000UL;
+
+// MOD * CDIV / PFD >= Timeout > MOD * (CDIV - 1) / PFD unless CDIV is clamped
+static bool CheckDivider(uint32_t Timeout) {
+  uint64_t Mod = MAX2870Field_M::Read(HostBus.Registers);
+  uint64_t ClockDivider = MAX2870Field_CDIV::Read(HostBus.Registers);
+  uint64_t TimeoutPFD = ((uint64_t)Timeout * ReferenceFrequency); // PFD is the reference with R = 1
+  bool Valid = (MAX2870Field_CDM::Read(HostBus.Registers) == 1 && ClockDivider >= 1);
+  if (Valid && ClockDivider < MAX2870_FAST_LOCK_DIVIDER_MAX) {
+    Valid = ((Mod * ClockDivider * 1000000ULL) >= TimeoutPFD);
+  }
+  if (Valid && ClockDivider > 1) {
+    Valid = ((Mod * (ClockDivider - 1) * 1000000ULL) < TimeoutPFD);
+  }
+  if (Valid == false) {
+    printf("timeout %lu uS: MOD %lu CDIV %lu\n", (unsigned long)Timeout, (unsigned long)Mod, (unsigned long)ClockDivider);
+  }
+  return Valid;
+}
+
+int main() {
+  HostBus.reset();
+  MAX2870 vfo;
+  vfo.init(10, 8, false, 9, false);
+  HOST_CHECK_EQUAL(MAX2870_ERROR_NONE, vfo.setrf(ReferenceFrequency, 1, MAX2870_REF_UNDIVIDED));
+  HOST_CHECK_EQUAL(MAX2870_ERROR_NONE, vfo.SetStepFreq(100000UL));
+  HOST_CHECK_EQUAL(MAX2870_ERROR_NONE, vfo.setf((uint64_t)2400100000ULL, 4, 0, MAX2870_AUX_DIVIDED, false, 0, 0));
+  HOST_CHECK_EQUAL(50, vfo.ReadMod()); // 4800.2 MHz VCO - FRAC/MOD of 2/100 reduced to 1/50
+
+  // 1 mS is 10000 PFD cycles - beyond CDIV without MOD but 200 with MOD 50
+  HOST_CHECK_EQUAL(MAX2870_ERROR_NONE, vfo.setFastLock(MAX2870_FAST_LOCK_HARDWARE, 1000, 0));
+  HOST_CHECK_EQUAL(200, MAX2870Field_CDIV::Read(HostBus.Registers));
+  HOST_CHECK(CheckDivider(1000));
+  HOST_CHECK_EQUAL(MAX2870_ERROR_FAST_LOCK_TIMEOUT, vfo.setFastLock(MAX2870_FAST_LOCK_HARDWARE, 30000, 0)); // CDIV of 6000
+  HOST_CHECK_EQUAL(200, MAX2870Field_CDIV::Read(HostBus.Registers));
+
+  // setfFast() writes the unreduced channel step MOD of 100
+  HOST_CHECK_EQUAL(MAX2870_ERROR_NONE, vfo.setfFast(2400200000ULL));
+  HOST_CHECK_EQUAL(100, MAX2870Field_M::Read(HostBus.Registers));
+  HOST_CHECK_EQUAL(100, MAX2870Field_CDIV::Read(HostBus.Registers));
+
+  HOST_CHECK_EQUAL(MAX2870_ERROR_NONE, vfo.setfDirect(1, 240, 7, 3, 2, true));
+  HOST_CHECK_EQUAL(7, MAX2870Field_M::Read(HostBus.Registers));
+  HOST_CHECK_EQUAL(1429, MAX2870Field_CDIV::Read(HostBus.Registers));
+
+  // random frequencies with 1 Hz steps for every MOD up to 4095
+  HOST_CHECK_EQUAL(MAX2870_ERROR_NONE, vfo.SetStepFreq(1UL));
+  const uint32_t Timeouts[3] = {1, 37, 1000};
+  uint64_t State = 1;
+  for (int i = 0; i < 3; i++) {
+    HOST_CHECK_EQUAL(MAX2870_ERROR_NONE, vfo.setFastLock(MAX2870_FAST_LOCK_HARDWARE, Timeouts[i], 0));
+    unsigned long Failures = 0;
+    for (int j = 0; j < 2000 && Failures < 10; j++) {
+      State = (State * 6364136223846793005ULL) + 1442695040888963407ULL;
+      uint64_t Frequency = 23437500ULL + ((State >> 16) % (6000000000ULL - 23437500ULL));
+      int ErrorCode = vfo.setf(Frequency, 4, 0, MAX2870_AUX_DIVIDED, false, 0, 0);
+      HOST_CHECK(ErrorCode == MAX2870_ERROR_NONE || ErrorCode == MAX2870_WARNING_FREQUENCY_ERROR);
+      if (CheckDivider(Timeouts[i]) == false) {
+        Failures++;
+      }
+    }
+    HOST_CHECK_EQUAL(0, Failures);
+  }
+
+  // other modes turn the clock divider off
+  HOST_CHECK_EQUAL(MAX2870_ERROR_NONE, vfo.setFastLock(MAX2870_FAST_LOCK_OFF, 0, 0));
+  HOST_CHECK_EQUAL(0, MAX2870Field_CDM::Read(HostBus.Registers));
+  HOST_CHECK_EQUAL(1, MAX2870Field_CDIV::Read(HostBus.Registers));
+
+  // serviceFastLock() writes R2 directly, which could race serviceQueue() from an interrupt
+  HOST_CHECK_EQUAL(MAX2870_ERROR_NONE, vfo.setWriteMode(MAX2870_WRITE_MODE_QUEUE));
+  HOST_CHECK_EQUAL(MAX2870_ERROR_FAST_LOCK_WRITE_MODE, vfo.setFastLock(MAX2870_FAST_LOCK_SOFTWARE, 100, 5.12));
+  HOST_CHECK_EQUAL(MAX2870_ERROR_NONE, vfo.setFastLock(MAX2870_FAST_LOCK_HARDWARE, 100, 0));
+  HOST_CHECK_EQUAL(MAX2870_ERROR_NONE, vfo.setWriteMode(MAX2870_WRITE_MODE_REGISTER));
+  HOST_CHECK_EQUAL(MAX2870_ERROR_NONE, vfo.setFastLock(MAX2870_FAST_LOCK_SOFTWARE, 100, 5.12));
+  HOST_CHECK_EQUAL(MAX2870_ERROR_FAST_LOCK_WRITE_MODE, vfo.setWriteMode(MAX2870_WRITE_MODE_QUEUE));
+  return HOST_TEST_RESULT();
+}
@@ -0,0 +1,244 @@
+/*!
+   @file test_gcd_corpus.cpp
+
+   This is part of the host (Linux) build of the Arduino Library for the MAX2870 PLL wideband frequency synthesier
+
+   Reproduces the table of unusual channel steps in README.md (10 MHz PFD) - MOD after the GCD, iterations of the
+   previous subtraction GCD and of the binary GCD, the error of the previous MOD halving and the error of the closest
+   FRAC/MOD written by setf() - and checks over a random corpus of small steps that setf() writes the closest FRAC/MOD
+   (or next INT) to the channel which is found by trying every MOD from 1 to 4095
+
+   The previous GCD and halving and the binary GCD iteration count are models - the errors of setf() are from the
+   registers latched on the bus
+
+*/
+
+#include <MAX2870.h>
+#include "HostTest.h"
+#include "HostReference.h"
+
+const uint32_t PFD = 10000000UL;
+
+struct CorpusCase {
+  uint32_t Step;
+  uint64_t Frequency;
+  uint32_t ModAfterGCD;
+  uint32_t PreviousIterations;
+  uint32_t BinaryIterations;
+  uint32_t PreviousError; // 0.1 Hz
+  uint32_t ClosestError; // 0.1 Hz
+};
+
+// as in README.md
+const CorpusCase Corpus[] = {
+  {1, 1500003530ULL, 500000UL, 1434, 32, 9698, 2},
+  {1, 3000000001ULL, 10000000UL, 9999999, 31, 10, 10},
+  {1, 5999999999ULL, 10000000UL, 9999999, 56, 40957, 10},
+  {2, 3000000002ULL, 5000000UL, 4999999, 30, 20, 20},
+  {10, 2400000010ULL, 500000UL, 499999, 26, 100, 100},
+};
+
+// channel step FRAC/MOD before the GCD as per CalculateFrequency() with R = 1
+static void ChannelFraction(uint32_t Step, uint64_t Frequency, uint32_t &Mod, uint32_t &Frac, uint64_t &Remainder, uint32_t &OutputDivider) {
+  uint32_t Ratio = (uint32_t)(3000000000ULL / Frequency);
+  OutputDivider = 1;
+  while (OutputDivider <= Ratio && OutputDivider <= 64) {
+    OutputDivider *= 2;
+  }
+  uint64_t VCO = Frequency * OutputDivider;
+  Remainder = (VCO % PFD);
+  Mod = (PFD / Step);
+  Frac = (uint32_t)(((Remainder * OutputDivider * 2) + Step) / ((uint64_t)Step * OutputDivider * 2));
+}
+
+// subtraction GCD of v1.2.0 and earlier
+static uint32_t SubtractionGCD(uint32_t a, uint32_t b, uint32_t &Iterations) {
+  Iterations = 0;
+  while (true) {
+    if (a == 0) {
+      return b;
+    }
+    if (b == 0 || a == b) {
+      return a;
+    }
+    if (a > b) {
+      a -= b;
+    }
+    else {
+      b -= a;
+    }
+    Iterations++;
+  }
+}
+
+// shifts and subtractions of BinaryGCD() in MAX2870Device.h
+static uint32_t BinaryGCDIterations(uint32_t a, uint32_t b) {
+  uint32_t Iterations = 0;
+  if (a == 0 || b == 0) {
+    return 0;
+  }
+  while (((a | b) & 1) == 0) {
+    a >>= 1;
+    b >>= 1;
+    Iterations++;
+  }
+  while ((a & 1) == 0) {
+    a >>= 1;
+    Iterations++;
+  }
+  while (b != 0) {
+    while ((b & 1) == 0) {
+      b >>= 1;
+      Iterations++;
+    }
+    if (a > b) {
+      uint32_t temp = a;
+      a = b;
+      b = temp;
+    }
+    b -= a;
+    Iterations++;
+  }
+  return Iterations;
+}
+
+// Numerator / Denominator Hz in 0.1 Hz rounded to the nearest
+static uint32_t Tenths(__int128 Numerator, __int128 Denominator) {
+  if (Numerator < 0) {
+    Numerator = -Numerator;
+  }
+  return (uint32_t)(((Numerator * 20) + Denominator) / (Denominator * 2));
+}
+
+// error (Hz) of MOD halving of v1.2.0 and earlier as Numerator / Denominator
+static void HalvingError(uint32_t Mod, uint32_t Frac, uint32_t OutputDivider, __int128 &Numerator, __int128 &Denominator) {
+  uint32_t HalvedMod = Mod;
+  uint32_t HalvedFrac = Frac;
+  if (HalvedMod > 4095) {
+    while (true) {
+      HalvedMod /= 2;
+      HalvedFrac /= 2;
+      if (HalvedMod <= 4095) {
+        if (HalvedFrac == HalvedMod) {
+          HalvedFrac--;
+        }
+        break;
+      }
+    }
+  }
+  Numerator = ((__int128)Frac * HalvedMod) - ((__int128)HalvedFrac * Mod);
+  Numerator *= PFD;
+  Denominator = (__int128)Mod * HalvedMod * OutputDivider;
+}
+
+// smallest error (Hz) of FRAC/MOD with MOD <= 4095 (FRAC = MOD is the next INT) for Remainder / PFD as Numerator / Denominator
+static void ClosestError(uint64_t Remainder, uint32_t OutputDivider, __int128 &Numerator, __int128 &Denominator) {
+  Numerator = -1;
+  Denominator = 1;
+  for (uint32_t Mod = 1; Mod <= 4095; Mod++) {
+    uint64_t Frac = (((uint64_t)Remainder * Mod * 2) + PFD) / ((uint64_t)PFD * 2);
+    __int128 Error = ((__int128)Remainder * Mod) - ((__int128)Frac * PFD);
+    if (Error < 0) {
+      Error = -Error;
+    }
+    __int128 ErrorDenominator = (__int128)Mod * OutputDivider;
+    if (Numerator < 0 || (Error * Denominator) < (Numerator * ErrorDenominator)) {
+      Numerator = Error;
+      Denominator = ErrorDenominator;
+    }
+  }
+}
+
+static void SetStep(MAX2870 &vfo, uint32_t Step) {
+  HostBus.reset();
+  HostBus.Logging = false;
+  vfo.init(10, 8, false, 9, false);
+  HOST_CHECK_EQUAL(MAX2870_ERROR_NONE, vfo.setrf(PFD, 1, MAX2870_REF_UNDIVIDED));
+  HOST_CHECK_EQUAL(MAX2870_ERROR_NONE, vfo.SetStepFreq(Step));
+}
+
+static void TestCorpus() {
+  printf("| Step (Hz) | RF frequency (Hz) | MOD after GCD | Previous GCD iterations | Binary GCD iterations | Previous error (Hz) | Closest FRAC/MOD error (Hz) |\n");
+  printf("| --- | --- | --- | --- | --- | --- | --- |\n");
+  for (size_t i = 0; i < (sizeof(Corpus) / sizeof(Corpus[0])); i++) {
+    const CorpusCase &Case = Corpus[i];
+    uint32_t Mod;
+    uint32_t Frac;
+    uint64_t Remainder;
+    uint32_t OutputDivider;
+    ChannelFraction(Case.Step, Case.Frequency, Mod, Frac, Remainder, OutputDivider);
+    uint32_t PreviousIterations;
+    uint32_t GCD = SubtractionGCD(Mod, Frac, PreviousIterations);
+    uint32_t BinaryIterations = BinaryGCDIterations(Mod, Frac);
+    __int128 Numerator;
+    __int128 Denominator;
+    HalvingError((Mod / GCD), (Frac / GCD), OutputDivider, Numerator, Denominator);
+    uint32_t PreviousError = Tenths(Numerator, Denominator);
+
+    MAX2870 vfo;
+    SetStep(vfo, Case.Step);
+    int ErrorCode = vfo.setf(Case.Frequency, 4, 0, MAX2870_AUX_DIVIDED, false, 0, 0);
+    DecodedRegisters Decoded = Decode(HostBus.Registers);
+    FrequencyOffset(Decoded, PFD, Case.Frequency, 1, Numerator, Denominator);
+    uint32_t Error = Tenths(Numerator, Denominator);
+    HOST_CHECK_EQUAL(ReferenceError(Decoded, PFD, Case.Frequency, 1), vfo.ReadFrequencyError());
+    HOST_CHECK_EQUAL(((vfo.ReadFrequencyError() == 0) ? MAX2870_ERROR_NONE : MAX2870_WARNING_FREQUENCY_ERROR), ErrorCode);
+
+    printf("| %lu | %llu | %lu | %lu | %lu | %lu.%lu | %lu.%lu |\n", (unsigned long)Case.Step, (unsigned long long)Case.Frequency, (unsigned long)(Mod / GCD),
+           (unsigned long)PreviousIterations, (unsigned long)BinaryIterations, (unsigned long)(PreviousError / 10), (unsigned long)(PreviousError % 10),
+           (unsigned long)(Error / 10), (unsigned long)(Error % 10));
+    HOST_CHECK_EQUAL(Case.ModAfterGCD, (Mod / GCD));
+    HOST_CHECK_EQUAL(Case.PreviousIterations, PreviousIterations);
+    HOST_CHECK_EQUAL(Case.BinaryIterations, BinaryIterations);
+    HOST_CHECK_EQUAL(Case.PreviousError, PreviousError);
+    HOST_CHECK_EQUAL(Case.ClosestError, Error);
+    HOST_CHECK(BinaryIterations <= 64);
+  }
+}
+
+// setf() must match the smallest error of any MOD up to 4095
+static void TestClosest(uint32_t Step, uint32_t Seed, int Count) {
+  MAX2870 vfo;
+  SetStep(vfo, Step);
+  uint64_t State = Seed;
+  unsigned long Failures = 0;
+  for (int i = 0; i < Count && Failures < 10; i++) {
+    State = (State * 6364136223846793005ULL) + 1442695040888963407ULL;
+    uint64_t Frequency = 23437500ULL + ((State >> 16) % (6000000000ULL - 23437500ULL));
+    Frequency -= (Frequency % Step);
+    if (Frequency <= 23437500ULL) {
+      Frequency += Step;
+    }
+    uint32_t Mod;
+    uint32_t Frac;
+    uint64_t Remainder;
+    uint32_t OutputDivider;
+    ChannelFraction(Step, Frequency, Mod, Frac, Remainder, OutputDivider);
+    __int128 BestNumerator;
+    __int128 BestDenominator;
+    ClosestError(Remainder, OutputDivider, BestNumerator, BestDenominator);
+    vfo.setf(Frequency, 4, 0, MAX2870_AUX_DIVIDED, false, 0, 0);
+    __int128 Numerator;
+    __int128 Denominator;
+    FrequencyOffset(Decode(HostBus.Registers), PFD, Frequency, 1, Numerator, Denominator);
+    if (Numerator < 0) {
+      Numerator = -Numerator;
+    }
+    if ((Numerator * BestDenominator) != (BestNumerator * Denominator)) {
+      printf("step %lu Hz %llu Hz: error %lu.%lu Hz closest %lu.%lu Hz\n", (unsigned long)Step, (unsigned long long)Frequency,
+             (unsigned long)(Tenths(Numerator, Denominator) / 10), (unsigned long)(Tenths(Numerator, Denominator) % 10),
+             (unsigned long)(Tenths(BestNumerator, BestDenominator) / 10), (unsigned long)(Tenths(BestNumerator, BestDenominator) % 10));
+      Failures++;
+    }
+  }
+  HOST_CHECK_EQUAL(0, Failures);
+}
+
+int main() {
+  TestCorpus();
+  const uint32_t Steps[] = {1, 2, 5, 10, 50, 64, 128, 640};
+  for (size_t i = 0; i < (sizeof(Steps) / sizeof(Steps[0])); i++) {
+    TestClosest(Steps[i], (i + 1), 500);
+  }
+  return HOST_TEST_RESULT();
+}
@@ -0,0 +1,117 @@
+/*!
+   @file test_plan_sweep.cpp
+
+   This is part of the host (Linux) build of the Arduino Library for the MAX2870 PLL wideband frequency synthesier
+
+   Checks planSweep() and planSweepCompact() against a loop of setf() calls in channel step mode - every register of
+   every planned step must be bit for bit the same as the registers setf() writes for that frequency (across every RF
+   divider band and with inexact steps), a compact step written with WriteCompactSweepValues() must latch the same
+   registers on the bus and the frequency error returned must be the largest error of setf() over the steps planned
+
+*/
+
+#include <MAX2870.h>
+#include "HostTest.h"
+
+const uint16_t BlockSteps = 256;
+
+struct SweepCase {
+  uint32_t ReferenceFrequency;
+  uint16_t R;
+  uint8_t ReferenceDivisionType;
+  uint32_t ChannelStep;
+  uint64_t StartFrequency;
+  uint64_t StopFrequency;
+  uint64_t StepFrequency;
+};
+
+const SweepCase Cases[] = {
+  {10000000UL, 1, MAX2870_REF_UNDIVIDED, 100000UL, 23500000ULL, 6000000000ULL, 5000000ULL}, // every band
+  {10000000UL, 1, MAX2870_REF_UNDIVIDED, 12500UL, 1400000000ULL, 1600000000ULL, 312500ULL}, // across the 1.5 GHz band edge
+  {25000000UL, 1, MAX2870_REF_UNDIVIDED, 25000UL, 2999000000ULL, 3001000000ULL, 25000ULL}, // across the 3 GHz band edge
+  {10000000UL, 1, MAX2870_REF_DOUBLE, 10000UL, 100000000ULL, 6000000000ULL, 23450000ULL},
+  {100000000UL, 4, MAX2870_REF_HALF, 12500UL, 700000000ULL, 800000000ULL, 387500ULL},
+  {10000000UL, 1, MAX2870_REF_UNDIVIDED, 1UL, 23437501ULL, 6000000000ULL, 12345677ULL}, // MOD beyond 4095 - inexact steps
+  {19200000UL, 1, MAX2870_REF_UNDIVIDED, 1UL, 1000000001ULL, 1100000000ULL, 987653ULL},
+};
+
+static void Setup(MAX2870 &vfo, const SweepCase &Case) {
+  vfo.init(10, 8, false, 9, false);
+  HOST_CHECK_EQUAL(MAX2870_ERROR_NONE, vfo.setrf(Case.ReferenceFrequency, Case.R, Case.ReferenceDivisionType));
+  HOST_CHECK_EQUAL(MAX2870_ERROR_NONE, vfo.SetStepFreq(Case.ChannelStep));
+}
+
+static int Setf(MAX2870 &vfo, uint64_t Frequency) {
+  return vfo.setf(Frequency, 4, 0, MAX2870_AUX_DIVIDED, false, 0, 0);
+}
+
+static void TestCase(const SweepCase &Case) {
+  HostBus.reset();
+  HostBus.Logging = false;
+  MAX2870 Reference; // setf() at each step
+  MAX2870 Planner; // planSweep()/planSweepCompact()
+  MAX2870 Player; // WriteCompactSweepValues() of each compact step
+  Setup(Reference, Case);
+  Setup(Planner, Case);
+  Setup(Player, Case);
+  int ErrorCode = Setf(Reference, Case.StartFrequency);
+  HOST_CHECK(ErrorCode == MAX2870_ERROR_NONE || ErrorCode == MAX2870_WARNING_FREQUENCY_ERROR);
+  Setf(Planner, Case.StartFrequency);
+  Setf(Player, Case.StartFrequency);
+
+  static uint32_t Registers[(BlockSteps * MAX2870_RegsToWrite)];
+  static MAX2870CompactStep Steps[BlockSteps];
+  unsigned long TotalSteps = 0;
+  unsigned long Failures = 0;
+  unsigned long Inexact = 0;
+  for (uint64_t BlockStart = Case.StartFrequency; BlockStart <= Case.StopFrequency; BlockStart += (Case.StepFrequency * BlockSteps)) {
+    uint16_t StepsPlanned = 0;
+    int PlanError = Planner.planSweep(BlockStart, Case.StopFrequency, Case.StepFrequency, Registers, BlockSteps, &StepsPlanned);
+    int32_t PlanFrequencyError = Planner.ReadFrequencyError();
+    uint16_t CompactStepsPlanned = 0;
+    int CompactPlanError = Planner.planSweepCompact(BlockStart, Case.StopFrequency, Case.StepFrequency, Steps, BlockSteps, &CompactStepsPlanned);
+    HOST_CHECK_EQUAL(StepsPlanned, CompactStepsPlanned);
+    HOST_CHECK_EQUAL(PlanError, CompactPlanError);
+    HOST_CHECK_EQUAL(PlanFrequencyError, Planner.ReadFrequencyError());
+
+    int32_t LargestFrequencyError = 0;
+    for (uint16_t Step = 0; Step < StepsPlanned && Failures < 10; Step++) {
+      uint64_t Frequency = BlockStart + (Step * Case.StepFrequency);
+      ErrorCode = Setf(Reference, Frequency);
+      HOST_CHECK(ErrorCode == MAX2870_ERROR_NONE || ErrorCode == MAX2870_WARNING_FREQUENCY_ERROR);
+      if (abs(Reference.ReadFrequencyError()) > abs(LargestFrequencyError)) {
+        LargestFrequencyError = Reference.ReadFrequencyError();
+      }
+      if (Reference.ReadFrequencyError() != 0) {
+        Inexact++;
+      }
+      const uint32_t *StepRegisters = &Registers[(Step * MAX2870_RegsToWrite)];
+      Player.WriteCompactSweepValues(&Steps[Step]);
+      for (int i = 0; i < (int)MAX2870_RegsToWrite; i++) {
+        if (StepRegisters[i] != Reference.MAX2870_R[i] || Player.MAX2870_R[i] != Reference.MAX2870_R[i] || HostBus.Registers[i] != Reference.MAX2870_R[i]) {
+          printf("%llu Hz R%d: setf() %08lX planSweep() %08lX compact %08lX latched %08lX\n", (unsigned long long)Frequency, i, (unsigned long)Reference.MAX2870_R[i],
+                 (unsigned long)StepRegisters[i], (unsigned long)Player.MAX2870_R[i], (unsigned long)HostBus.Registers[i]);
+          Failures++;
+        }
+      }
+    }
+    HOST_CHECK_EQUAL(LargestFrequencyError, PlanFrequencyError);
+    HOST_CHECK_EQUAL(((LargestFrequencyError == 0) ? MAX2870_ERROR_NONE : MAX2870_WARNING_FREQUENCY_ERROR), PlanError);
+    TotalSteps += StepsPlanned;
+    if (StepsPlanned == 0) {
+      break;
+    }
+  }
+  HOST_CHECK_EQUAL(0, Failures);
+  HOST_CHECK_EQUAL((((Case.StopFrequency - Case.StartFrequency) / Case.StepFrequency) + 1), TotalSteps);
+  printf("reference %lu Hz/%u step %lu Hz sweep %llu to %llu Hz step %llu Hz: %lu steps %lu inexact\n", (unsigned long)Case.ReferenceFrequency, Case.R,
+         (unsigned long)Case.ChannelStep, (unsigned long long)Case.StartFrequency, (unsigned long long)Case.StopFrequency, (unsigned long long)Case.StepFrequency,
+         TotalSteps, Inexact);
+}
+
+int main() {
+  for (size_t i = 0; i < (sizeof(Cases) / sizeof(Cases[0])); i++) {
+    TestCase(Cases[i]);
+  }
+  return HOST_TEST_RESULT();
+}
@@ -0,0 +1,205 @@
+/*!
+   @file test_playback.cpp
+
+   This is part of the host (Linux) build of the Arduino Library for the MAX2870 PLL wideband frequency synthesier
+
+   Checks that playback cannot start under MAX2870_WRITE_MODE_QUEUE or MAX2870_VCO_CACHE_LEARN (tick() from an interrupt
+   could wait forever for serviceQueue() or search for a VCO band), that neither mode can be set during playback, that
+   compact playback cannot start under MAX2870_VCO_CACHE_ON or MAX2870_FAST_LOCK_HARDWARE (tick() would divide in 64 bits
+   for the VCO bucket and the fast lock clock divider of each step) and neither can be set during compact playback, and
+   that tick() latches the registers of each step of a register table and a compact table on the bus in the playback
+   order with the step timing of the dwell ticks, that setPlaybackOrder() during playback does not change the order of
+   the running playback and that ReadPlaybackStatistics() reads the statistics with interrupts disabled
+
+*/
+
+#include <MAX2870.h>
+#include "HostTest.h"
+
+const uint64_t StartFrequency = 2400000000ULL;
+const uint64_t StepFrequency = 1000000ULL;
+const uint16_t Steps = 20;
+
+static uint32_t Registers[(Steps * MAX2870_RegsToWrite)];
+static MAX2870CompactStep CompactSteps[Steps];
+static uint16_t DwellTicks[Steps];
+
+static void Setup(MAX2870 &vfo) {
+  HostBus.reset();
+  vfo.init(10, 8, false, 9, false);
+  HOST_CHECK_EQUAL(MAX2870_ERROR_NONE, vfo.setrf(10000000UL, 1, MAX2870_REF_UNDIVIDED));
+  HOST_CHECK_EQUAL(MAX2870_ERROR_NONE, vfo.SetStepFreq(StepFrequency));
+  HOST_CHECK_EQUAL(MAX2870_ERROR_NONE, vfo.setf(StartFrequency, 4, 0, MAX2870_AUX_DIVIDED, false, 0, 0));
+  uint16_t StepsPlanned = 0;
+  HOST_CHECK_EQUAL(MAX2870_ERROR_NONE, vfo.planSweep(StartFrequency, (StartFrequency + (StepFrequency * (Steps - 1))), StepFrequency, Registers, Steps, &StepsPlanned));
+  HOST_CHECK_EQUAL(Steps, StepsPlanned);
+  HOST_CHECK_EQUAL(MAX2870_ERROR_NONE, vfo.planSweepCompact(StartFrequency, (StartFrequency + (StepFrequency * (Steps - 1))), StepFrequency, CompactSteps, Steps, &StepsPlanned));
+  for (uint16_t i = 0; i < Steps; i++) {
+    DwellTicks[i] = (1 + (i % 3));
+  }
+}
+
+static void TestRefusedModes() {
+  MAX2870 vfo;
+  Setup(vfo);
+  HOST_CHECK_EQUAL(MAX2870_ERROR_NONE, vfo.setWriteMode(MAX2870_WRITE_MODE_QUEUE));
+  HOST_CHECK_EQUAL(MAX2870_ERROR_PLAYBACK_WRITE_MODE, vfo.startPlayback(Registers, Steps, NULL, 1, 0, false));
+  HOST_CHECK_EQUAL(MAX2870_ERROR_PLAYBACK_WRITE_MODE, vfo.startPlaybackCompact(CompactSteps, Steps, NULL, 1, 0, false));
+  HOST_CHECK(vfo.MAX2870_PlaybackRunning == false);
+  HOST_CHECK_EQUAL(MAX2870_ERROR_NONE, vfo.setWriteMode(MAX2870_WRITE_MODE_REGISTER));
+  HOST_CHECK_EQUAL(MAX2870_ERROR_NONE, vfo.setVCOCache(MAX2870_VCO_CACHE_LEARN));
+  HOST_CHECK_EQUAL(MAX2870_ERROR_PLAYBACK_WRITE_MODE, vfo.startPlayback(Registers, Steps, NULL, 1, 0, false));
+  HOST_CHECK(vfo.MAX2870_PlaybackRunning == false);
+  HOST_CHECK_EQUAL(MAX2870_ERROR_NONE, vfo.setVCOCache(MAX2870_VCO_CACHE_ON));
+  HOST_CHECK_EQUAL(MAX2870_ERROR_NONE, vfo.startPlayback(Registers, Steps, NULL, 1, 0, false));
+  HOST_CHECK(vfo.MAX2870_PlaybackRunning == true);
+  HOST_CHECK_EQUAL(MAX2870_ERROR_PLAYBACK_WRITE_MODE, vfo.setWriteMode(MAX2870_WRITE_MODE_QUEUE));
+  HOST_CHECK_EQUAL(MAX2870_ERROR_PLAYBACK_WRITE_MODE, vfo.setVCOCache(MAX2870_VCO_CACHE_LEARN));
+  HOST_CHECK_EQUAL(MAX2870_ERROR_NONE, vfo.setWriteMode(MAX2870_WRITE_MODE_BURST));
+  vfo.stopPlayback();
+  HOST_CHECK_EQUAL(MAX2870_ERROR_NONE, vfo.setWriteMode(MAX2870_WRITE_MODE_QUEUE));
+  HOST_CHECK_EQUAL(MAX2870_ERROR_NONE, vfo.setWriteMode(MAX2870_WRITE_MODE_BURST)); // MAX2870_VCO_CACHE_LEARN is refused under MAX2870_WRITE_MODE_QUEUE
+  HOST_CHECK_EQUAL(MAX2870_ERROR_NONE, vfo.setVCOCache(MAX2870_VCO_CACHE_LEARN));
+}
+
+static void TestCompactRefusedModes() {
+  MAX2870 vfo;
+  Setup(vfo);
+  HOST_CHECK_EQUAL(MAX2870_ERROR_NONE, vfo.setVCOCache(MAX2870_VCO_CACHE_ON));
+  HOST_CHECK_EQUAL(MAX2870_ERROR_PLAYBACK_WRITE_MODE, vfo.startPlaybackCompact(CompactSteps, Steps, NULL, 1, 0, false));
+  HOST_CHECK(vfo.MAX2870_PlaybackRunning == false);
+  HOST_CHECK_EQUAL(MAX2870_ERROR_NONE, vfo.startPlayback(Registers, Steps, NULL, 1, 0, false)); // the register table has the VCO bands
+  vfo.stopPlayback();
+  HOST_CHECK_EQUAL(MAX2870_ERROR_NONE, vfo.setVCOCache(MAX2870_VCO_CACHE_OFF));
+  HOST_CHECK_EQUAL(MAX2870_ERROR_NONE, vfo.setFastLock(MAX2870_FAST_LOCK_HARDWARE, 10, 0));
+  HOST_CHECK_EQUAL(MAX2870_ERROR_PLAYBACK_WRITE_MODE, vfo.startPlaybackCompact(CompactSteps, Steps, NULL, 1, 0, false));
+  HOST_CHECK(vfo.MAX2870_PlaybackRunning == false);
+  HOST_CHECK_EQUAL(MAX2870_ERROR_NONE, vfo.startPlayback(Registers, Steps, NULL, 1, 0, false));
+  vfo.stopPlayback();
+  HOST_CHECK_EQUAL(MAX2870_ERROR_NONE, vfo.setFastLock(MAX2870_FAST_LOCK_OFF, 0, 0));
+  HOST_CHECK_EQUAL(MAX2870_ERROR_NONE, vfo.startPlaybackCompact(CompactSteps, Steps, NULL, 1, 0, false));
+  HOST_CHECK(vfo.MAX2870_PlaybackRunning == true);
+  HOST_CHECK_EQUAL(MAX2870_ERROR_PLAYBACK_WRITE_MODE, vfo.setVCOCache(MAX2870_VCO_CACHE_ON));
+  HOST_CHECK_EQUAL(MAX2870_ERROR_PLAYBACK_WRITE_MODE, vfo.setFastLock(MAX2870_FAST_LOCK_HARDWARE, 10, 0));
+  vfo.stopPlayback();
+  HOST_CHECK_EQUAL(MAX2870_ERROR_NONE, vfo.setVCOCache(MAX2870_VCO_CACHE_ON));
+  HOST_CHECK_EQUAL(MAX2870_ERROR_NONE, vfo.setFastLock(MAX2870_FAST_LOCK_HARDWARE, 10, 0));
+}
+
+// tick() until playback stops (no repeat) - every step must be latched on the tick its dwell ends with R0 last
+static void TestPlayback(bool Compact, uint8_t Order, uint8_t WriteMode) {
+  MAX2870 vfo;
+  Setup(vfo);
+  HOST_CHECK_EQUAL(MAX2870_ERROR_NONE, vfo.setWriteMode(WriteMode));
+  HOST_CHECK_EQUAL(MAX2870_ERROR_NONE, vfo.setPlaybackOrder(Order, 7));
+  if (Compact) {
+    HOST_CHECK_EQUAL(MAX2870_ERROR_NONE, vfo.startPlaybackCompact(CompactSteps, Steps, DwellTicks, 0, 0, false));
+  }
+  else {
+    HOST_CHECK_EQUAL(MAX2870_ERROR_NONE, vfo.startPlayback(Registers, Steps, DwellTicks, 0, 0, false));
+  }
+  bool Played[Steps] = {};
+  uint16_t TicksToStep = 1;
+  unsigned long Failures = 0;
+  for (int Tick = 0; Tick < 200 && vfo.MAX2870_PlaybackRunning == true; Tick++) {
+    uint32_t StepsBefore = vfo.MAX2870_PlaybackStepsWritten;
+    size_t Event = HostBus.Events.size();
+    vfo.tick();
+    TicksToStep--;
+    std::vector<uint32_t> Words = HostBus.wordsSince(Event);
+    if (vfo.MAX2870_PlaybackStepsWritten == StepsBefore) {
+      if (TicksToStep == 0 || Words.size() != 0) {
+        Failures++;
+      }
+      continue;
+    }
+    // the step written is the one whose R0 is now latched
+    int Step = -1;
+    for (uint16_t i = 0; i < Steps; i++) {
+      if (Registers[(i * MAX2870_RegsToWrite)] == HostBus.Registers[0]) {
+        Step = i;
+      }
+    }
+    if (TicksToStep != 0 || Step < 0 || Played[Step] || (Words.size() != 0 && Words.back() != HostBus.Registers[0])) { // no words when the step is already latched
+      printf("tick %d: step %d %lu words\n", Tick, Step, (unsigned long)Words.size());
+      Failures++;
+      continue;
+    }
+    Played[Step] = true;
+    if (Order == MAX2870_PLAYBACK_ORDER_SEQUENTIAL) {
+      HOST_CHECK_EQUAL(StepsBefore, Step);
+    }
+    for (int i = 0; i < (int)MAX2870_RegsToWrite; i++) {
+      HOST_CHECK_EQUAL(Registers[((Step * MAX2870_RegsToWrite) + i)], HostBus.Registers[i]);
+      HOST_CHECK_EQUAL(Registers[((Step * MAX2870_RegsToWrite) + i)], vfo.MAX2870_R[i]);
+    }
+    TicksToStep = DwellTicks[Step];
+  }
+  HOST_CHECK_EQUAL(0, Failures);
+  HOST_CHECK(vfo.MAX2870_PlaybackRunning == false);
+  HOST_CHECK_EQUAL(Steps, vfo.MAX2870_PlaybackStepsWritten);
+  for (uint16_t i = 0; i < Steps; i++) {
+    HOST_CHECK(Played[i]);
+  }
+}
+
+// setPlaybackOrder() during playback only applies to the next playback - every step is still written once
+static void TestOrderChange(uint8_t Order, uint8_t NewOrder) {
+  MAX2870 vfo;
+  Setup(vfo);
+  HOST_CHECK_EQUAL(MAX2870_ERROR_NONE, vfo.setPlaybackOrder(Order, 7));
+  HOST_CHECK_EQUAL(MAX2870_ERROR_NONE, vfo.startPlayback(Registers, Steps, NULL, 1, 0, false));
+  bool Played[Steps] = {};
+  uint16_t StepsPlayed = 0;
+  for (int Tick = 0; Tick < 100 && vfo.MAX2870_PlaybackRunning == true; Tick++) {
+    if (Tick == 3) {
+      HOST_CHECK_EQUAL(MAX2870_ERROR_NONE, vfo.setPlaybackOrder(NewOrder, 3));
+    }
+    vfo.tick();
+    for (uint16_t i = 0; i < Steps; i++) {
+      if (Registers[(i * MAX2870_RegsToWrite)] == HostBus.Registers[0] && Played[i] == false) {
+        if (Order == MAX2870_PLAYBACK_ORDER_SEQUENTIAL) {
+          HOST_CHECK_EQUAL(StepsPlayed, i);
+        }
+        Played[i] = true;
+        StepsPlayed++;
+      }
+    }
+  }
+  HOST_CHECK(vfo.MAX2870_PlaybackRunning == false);
+  HOST_CHECK_EQUAL(Steps, StepsPlayed);
+}
+
+static void TestStatistics() {
+  MAX2870 vfo;
+  Setup(vfo);
+  HOST_CHECK_EQUAL(MAX2870_ERROR_NONE, vfo.startPlaybackCompact(CompactSteps, Steps, DwellTicks, 0, 100, false));
+  for (int Tick = 0; Tick < 200 && vfo.MAX2870_PlaybackRunning == true; Tick++) {
+    vfo.tick();
+  }
+  uint32_t InterruptDisables = HostBus.InterruptDisables;
+  MAX2870PlaybackStatistics Statistics;
+  vfo.ReadPlaybackStatistics(&Statistics);
+  HOST_CHECK(HostBus.InterruptDisables > InterruptDisables);
+  HOST_CHECK_EQUAL(0, HostBus.InterruptsDisabled);
+  HOST_CHECK_EQUAL(0, HostBus.InterruptErrors);
+  HOST_CHECK_EQUAL(Steps, Statistics.StepsWritten);
+  HOST_CHECK(Statistics.MinimumWriteTime <= Statistics.MeanWriteTime && Statistics.MeanWriteTime <= Statistics.MaximumWriteTime);
+  HOST_CHECK(Statistics.RegistersWritten != 0);
+}
+
+int main() {
+  TestRefusedModes();
+  TestCompactRefusedModes();
+  TestOrderChange(MAX2870_PLAYBACK_ORDER_SEQUENTIAL, MAX2870_PLAYBACK_ORDER_RANDOM);
+  TestOrderChange(MAX2870_PLAYBACK_ORDER_RANDOM, MAX2870_PLAYBACK_ORDER_SEQUENTIAL);
+  TestStatistics();
+  const uint8_t WriteModes[2] = {MAX2870_WRITE_MODE_REGISTER, MAX2870_WRITE_MODE_BURST};
+  for (int i = 0; i < 2; i++) {
+    TestPlayback(false, MAX2870_PLAYBACK_ORDER_SEQUENTIAL, WriteModes[i]);
+    TestPlayback(true, MAX2870_PLAYBACK_ORDER_SEQUENTIAL, WriteModes[i]);
+    TestPlayback(false, MAX2870_PLAYBACK_ORDER_RANDOM, WriteModes[i]);
+    TestPlayback(true, MAX2870_PLAYBACK_ORDER_RANDOM, WriteModes[i]);
+  }
+  return HOST_TEST_RESULT();
+}
@@ -0,0 +1,100 @@
+/*!
+   @file test_precision_search.cpp
+
+   This is part of the host (Linux) build of the Arduino Library for the MAX2870 PLL wideband frequency synthesier
+
+   Checks that the rational (Stern-Brocot) precision search gives the same registers (INT, FRAC, MOD, R and the RF
+   divider), error code and frequency error as the linear search through every MOD value for random frequencies,
+   frequency tolerances, reference frequencies, R dividers and reference doubler/halver settings with setf() and
+   setfMilliHz() under precision frequency mode
+
+*/
+
+#include <MAX2870.h>
+#include "HostTest.h"
+
+static uint64_t RandomState;
+
+static uint64_t Random(uint64_t Range) {
+  RandomState = (RandomState * 6364136223846793005ULL) + 1442695040888963407ULL;
+  return ((RandomState >> 16) % Range);
+}
+
+struct SearchResult {
+  int ErrorCode;
+  int32_t FrequencyError;
+  uint32_t Registers[6];
+};
+
+static SearchResult Search(MAX2870 &vfo, uint8_t SearchType, uint64_t Frequency, bool MilliHz, uint32_t Tolerance) {
+  SearchResult Result;
+  HOST_CHECK_EQUAL(MAX2870_ERROR_NONE, vfo.setPrecisionSearch(SearchType));
+  if (MilliHz == true) {
+    Result.ErrorCode = vfo.setfMilliHz(Frequency, 4, 0, MAX2870_AUX_DIVIDED, true, Tolerance, 0);
+  }
+  else {
+    Result.ErrorCode = vfo.setf(Frequency, 4, 0, MAX2870_AUX_DIVIDED, true, Tolerance, 0);
+  }
+  Result.FrequencyError = vfo.ReadFrequencyError();
+  for (int i = 0; i < 6; i++) {
+    Result.Registers[i] = HostBus.Registers[i];
+  }
+  return Result;
+}
+
+static void TestRandom(uint32_t Seed, int Count) {
+  HostBus.reset();
+  HostBus.Logging = false;
+  MAX2870 vfo;
+  vfo.init(10, 8, false, 9, false);
+  RandomState = Seed;
+  const uint8_t ReferenceDivisionTypes[3] = {MAX2870_REF_UNDIVIDED, MAX2870_REF_DOUBLE, MAX2870_REF_HALF};
+  const uint32_t Tolerances[6] = {0, 1, 10, 100, 1000, 100000};
+  unsigned long Failures = 0;
+  unsigned long Fractional = 0;
+  for (int i = 0; i < Count && Failures < 10; i++) {
+    uint32_t ReferenceFrequency;
+    uint16_t R;
+    uint8_t ReferenceDivisionType;
+    do {
+      ReferenceFrequency = MAX2870_REFIN_MIN + Random((MAX2870_REFIN_MAX - MAX2870_REFIN_MIN) + 1);
+      R = 1 + ((Random(4) == 0) ? Random(1023) : Random(16)); // mostly small R for a PFD within the fractional-N limit
+      ReferenceDivisionType = ReferenceDivisionTypes[Random(3)];
+    } while (vfo.setrf(ReferenceFrequency, R, ReferenceDivisionType) != MAX2870_ERROR_NONE);
+    bool MilliHz = (Random(2) == 0);
+    uint64_t Frequency = 23437500ULL + Random((6000000000ULL - 23437500ULL) + 1);
+    if (MilliHz == true) {
+      Frequency = (Frequency * 1000) + Random(1000);
+    }
+    uint32_t Tolerance = Tolerances[Random(6)];
+    if (Random(2) == 0) {
+      Tolerance = Random(Tolerance + 1);
+    }
+    SearchResult Linear = Search(vfo, MAX2870_PRECISION_SEARCH_LINEAR, Frequency, MilliHz, Tolerance);
+    SearchResult Rational = Search(vfo, MAX2870_PRECISION_SEARCH_RATIONAL, Frequency, MilliHz, Tolerance);
+    bool Match = (Linear.ErrorCode == Rational.ErrorCode && Linear.FrequencyError == Rational.FrequencyError);
+    for (int j = 0; j < 6; j++) {
+      if (Linear.Registers[j] != Rational.Registers[j]) {
+        Match = false;
+      }
+    }
+    if (Match == false) {
+      printf("%llu %s (reference %lu Hz/%u type %u tolerance %lu Hz): linear %d/%ld R0 0x%08lX R1 0x%08lX rational %d/%ld R0 0x%08lX R1 0x%08lX\n",
+             (unsigned long long)Frequency, ((MilliHz == true) ? "mHz" : "Hz"), (unsigned long)ReferenceFrequency, R, ReferenceDivisionType, (unsigned long)Tolerance,
+             Linear.ErrorCode, (long)Linear.FrequencyError, (unsigned long)Linear.Registers[0], (unsigned long)Linear.Registers[1],
+             Rational.ErrorCode, (long)Rational.FrequencyError, (unsigned long)Rational.Registers[0], (unsigned long)Rational.Registers[1]);
+      Failures++;
+    }
+    if (MAX2870Field_FRAC::Get(Rational.Registers[0]) != 0) {
+      Fractional++;
+    }
+  }
+  HOST_CHECK_EQUAL(0, Failures);
+  HOST_CHECK(Fractional > 0);
+}
+
+int main() {
+  TestRandom(1, 20000);
+  TestRandom(2, 20000);
+  return HOST_TEST_RESULT();
+}
@@ -0,0 +1,95 @@
+/*!
+   @file test_queue.cpp
+
+   This is part of the host (Linux) build of the Arduino Library for the MAX2870 PLL wideband frequency synthesier
+
+   Checks MAX2870_WRITE_MODE_QUEUE with serviceQueue() called from the same context as the writes (as from loop()) - a
+   write with a full queue must return MAX2870_ERROR_QUEUE_FULL through setf() and the other functions which write
+   registers instead of waiting forever, nothing may reach the bus until serviceQueue() and the changes of a refused
+   write must be latched by the next write which is queued
+
+*/
+
+#include <MAX2870.h>
+#include "HostTest.h"
+
+static void Drain(MAX2870 &vfo) {
+  while (vfo.queuedWrites() != 0) {
+    vfo.serviceQueue();
+  }
+}
+
+static bool Latched(MAX2870 &vfo) {
+  for (int i = 0; i < (int)MAX2870_RegsToWrite; i++) {
+    if (HostBus.Registers[i] != vfo.MAX2870_R[i]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+int main() {
+  HostBus.reset();
+  MAX2870 vfo;
+  vfo.init(10, 8, false, 9, false);
+  HOST_CHECK_EQUAL(MAX2870_ERROR_NONE, vfo.setrf(10000000UL, 1, MAX2870_REF_UNDIVIDED));
+  HOST_CHECK_EQUAL(MAX2870_ERROR_NONE, vfo.SetStepFreq(100000UL));
+  HOST_CHECK_EQUAL(MAX2870_ERROR_NONE, vfo.setf((uint64_t)2400000000ULL, 4, 0, MAX2870_AUX_DIVIDED, false, 0, 0));
+  HOST_CHECK_EQUAL(MAX2870_ERROR_NONE, vfo.setWriteMode(MAX2870_WRITE_MODE_QUEUE));
+
+  // fill the queue - nothing is written to the bus
+  uint32_t WordsLatched = HostBus.WordsLatched;
+  for (int i = 0; i < MAX2870_QUEUE_SIZE; i++) {
+    HOST_CHECK_EQUAL(MAX2870_ERROR_NONE, vfo.setf((2400100000ULL + (i * 100000ULL)), 4, 0, MAX2870_AUX_DIVIDED, false, 0, 0));
+  }
+  HOST_CHECK_EQUAL(MAX2870_QUEUE_SIZE, vfo.queuedWrites());
+  HOST_CHECK_EQUAL(WordsLatched, HostBus.WordsLatched);
+
+  // every function which writes registers returns the error with a full queue
+  HOST_CHECK_EQUAL(MAX2870_ERROR_QUEUE_FULL, vfo.setf((uint64_t)2450000000ULL, 4, 0, MAX2870_AUX_DIVIDED, false, 0, 0));
+  HOST_CHECK_EQUAL(MAX2870_ERROR_QUEUE_FULL, vfo.setfMilliHz(2450000000000ULL, 4, 0, MAX2870_AUX_DIVIDED, false, 0, 0));
+  HOST_CHECK_EQUAL(MAX2870_ERROR_QUEUE_FULL, vfo.setfFast(2450000000ULL));
+  HOST_CHECK_EQUAL(MAX2870_ERROR_QUEUE_FULL, vfo.setPowerLevel(2));
+  HOST_CHECK_EQUAL(MAX2870_ERROR_QUEUE_FULL, vfo.setAuxPowerLevel(3));
+  HOST_CHECK_EQUAL(MAX2870_ERROR_QUEUE_FULL, vfo.setCPcurrent(1.28));
+  HOST_CHECK_EQUAL(MAX2870_ERROR_QUEUE_FULL, vfo.setPDpolarity(MAX2870_LOOP_TYPE_NONINVERTING));
+  HOST_CHECK_EQUAL(MAX2870_ERROR_QUEUE_FULL, vfo.setADCMode(MAX2870_ADC_TEMPERATURE));
+  HOST_CHECK_EQUAL(MAX2870_ERROR_QUEUE_FULL, vfo.setfDirect(1, 245, 2, 0, 2, false));
+  HOST_CHECK_EQUAL(MAX2870_ERROR_QUEUE_FULL, vfo.WriteRegs());
+  HOST_CHECK_EQUAL(MAX2870_ERROR_QUEUE_FULL, vfo.WriteAllRegs());
+  uint32_t Registers[MAX2870_RegsToWrite];
+  vfo.ReadSweepValues(Registers);
+  HOST_CHECK_EQUAL(MAX2870_ERROR_QUEUE_FULL, vfo.WriteSweepValues(Registers));
+  MAX2870CompactStep Step;
+  vfo.ReadCompactSweepValues(&Step);
+  HOST_CHECK_EQUAL(MAX2870_ERROR_QUEUE_FULL, vfo.WriteCompactSweepValues(&Step));
+  HOST_CHECK_EQUAL(MAX2870_QUEUE_SIZE, vfo.queuedWrites());
+  HOST_CHECK_EQUAL(WordsLatched, HostBus.WordsLatched);
+
+  // one slot free - the next write is queued with the changes of the refused writes
+  vfo.serviceQueue();
+  HOST_CHECK_EQUAL((MAX2870_QUEUE_SIZE - 1), vfo.queuedWrites());
+  HOST_CHECK_EQUAL(MAX2870_ERROR_NONE, vfo.setPowerLevel(3));
+  Drain(vfo);
+  HOST_CHECK(Latched(vfo));
+
+  // a sweep step with a full queue stays in the ring until the queue has room
+  for (int i = 0; i < MAX2870_QUEUE_SIZE; i++) {
+    HOST_CHECK_EQUAL(MAX2870_ERROR_NONE, vfo.setf((2400100000ULL + (i * 100000ULL)), 4, 0, MAX2870_AUX_DIVIDED, false, 0, 0));
+  }
+  HOST_CHECK_EQUAL(MAX2870_ERROR_QUEUE_FULL, vfo.startSweep(1000000000ULL, 1000500000ULL, 100000ULL, 0, false));
+  HOST_CHECK(vfo.MAX2870_SweepRunning == true);
+  HOST_CHECK_EQUAL(0, vfo.MAX2870_SweepStepsWritten);
+  int Steps = 0;
+  for (int i = 0; i < 100 && vfo.MAX2870_SweepRunning == true; i++) {
+    vfo.serviceQueue();
+    int ErrorCode = vfo.serviceSweep();
+    HOST_CHECK(ErrorCode == MAX2870_ERROR_NONE || ErrorCode == MAX2870_ERROR_QUEUE_FULL);
+    Steps = vfo.MAX2870_SweepStepsWritten;
+  }
+  HOST_CHECK_EQUAL(6, Steps);
+  Drain(vfo);
+  HOST_CHECK(Latched(vfo));
+  HOST_CHECK_EQUAL(1000500000ULL, (((uint64_t)vfo.ReadInt() * vfo.ReadMod()) + vfo.ReadFraction()) * 10000000ULL / ((uint64_t)vfo.ReadMod() * vfo.ReadOutDivider()));
+  return HOST_TEST_RESULT();
+}
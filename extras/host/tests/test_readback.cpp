@@ -0,0 +1,55 @@
+/*!
+   @file test_readback.cpp
+
+   This is part of the host (Linux) build of the Arduino Library for the MAX2870 PLL wideband frequency synthesier
+
+   Checks readStatusRegister() during a MAX2870_FAST_LOCK_SOFTWARE boost - the read must return R6, leave MUXOUT as it
+   was and leave the boosted charge pump current latched with its restore by serviceFastLock() still pending
+
+*/
+
+#include <MAX2870.h>
+#include "HostTest.h"
+
+const uint32_t FastLockTimeout = 100; // uS
+
+int main() {
+  HostBus.reset();
+  MAX2870 vfo;
+  vfo.init(10, 8, true, 9, false);
+  HOST_CHECK_EQUAL(MAX2870_ERROR_NONE, vfo.setrf(10000000UL, 1, MAX2870_REF_UNDIVIDED));
+  HOST_CHECK_EQUAL(MAX2870_ERROR_NONE, vfo.SetStepFreq(100000UL));
+  HOST_CHECK_EQUAL(MAX2870_ERROR_NONE, vfo.setFastLock(MAX2870_FAST_LOCK_SOFTWARE, FastLockTimeout, 5.12));
+  HOST_CHECK_EQUAL(MAX2870_ERROR_NONE, vfo.setf((uint64_t)2400000000ULL, 4, 0, MAX2870_AUX_DIVIDED, false, 0, 0));
+  uint32_t CP = MAX2870Field_CP::Read(vfo.MAX2870_R);
+  uint32_t BoostCP = MAX2870Field_CP::Read(HostBus.Registers);
+  uint32_t MUX = MAX2870Field_MUX::Read(HostBus.Registers);
+  uint32_t MUX_MSB = MAX2870Field_MUX_MSB::Read(HostBus.Registers);
+  HOST_CHECK(BoostCP != CP);
+
+  HostBus.Readback = (0x00000006 | (23UL << 3));
+  MAX2870Status Status;
+  HOST_CHECK_EQUAL(MAX2870_ERROR_NONE, vfo.readStatusRegister(&Status));
+  HOST_CHECK_EQUAL(23, Status.VCO);
+  HOST_CHECK(Status.VASActive == false);
+  HOST_CHECK_EQUAL(BoostCP, MAX2870Field_CP::Read(HostBus.Registers));
+  HOST_CHECK_EQUAL(MUX, MAX2870Field_MUX::Read(HostBus.Registers));
+  HOST_CHECK_EQUAL(MUX_MSB, MAX2870Field_MUX_MSB::Read(HostBus.Registers));
+  HOST_CHECK(vfo.serviceFastLock() == true);
+
+  // the boost is restored after the timeout
+  HostBus.advance(FastLockTimeout * 1000ULL);
+  HOST_CHECK(vfo.serviceFastLock() == false);
+  HOST_CHECK_EQUAL(CP, MAX2870Field_CP::Read(HostBus.Registers));
+  for (int i = 0; i < (int)MAX2870_RegsToWrite; i++) {
+    HOST_CHECK_EQUAL(vfo.MAX2870_R[i], HostBus.Registers[i]);
+  }
+
+  // with MUXOUT not connected the read fails without changing the latched registers
+  HostBus.ReadbackPin = 13;
+  HOST_CHECK_EQUAL(MAX2870_ERROR_READBACK, vfo.readStatusRegister(&Status));
+  for (int i = 0; i < (int)MAX2870_RegsToWrite; i++) {
+    HOST_CHECK_EQUAL(vfo.MAX2870_R[i], HostBus.Registers[i]);
+  }
+  return HOST_TEST_RESULT();
+}
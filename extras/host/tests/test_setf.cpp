@@ -0,0 +1,107 @@
+/*!
+   @file test_setf.cpp
+
+   This is part of the host (Linux) build of the Arduino Library for the MAX2870 PLL wideband frequency synthesier
+
+   Checks setf() in channel step mode against an exact reference - the registers latched on the bus are decoded
+   (independently of MAX2870Fields.h) and the RF frequency they give is compared with the requested frequency in
+   128 bit arithmetic: every frequency on the channel grid must be exact and the frequency error reported when it
+   cannot be must be the error of the registers rounded to the nearest Hz
+
+*/
+
+#include <MAX2870.h>
+#include "HostTest.h"
+#include "HostReference.h"
+
+static void CheckRegisterRanges(const DecodedRegisters &Decoded, uint64_t Frequency) {
+  HOST_CHECK(Decoded.Mod >= 2 && Decoded.Mod <= 4095);
+  HOST_CHECK(Decoded.Frac < Decoded.Mod);
+  uint64_t VCO = Frequency * Decoded.RfDivider;
+  if (Frequency > 23437500ULL) {
+    HOST_CHECK(VCO >= 3000000000ULL && VCO <= 6000000000ULL);
+  }
+}
+
+// every frequency on the grid is on the channel step so must be exact with the same registers from setfMilliHz()
+static void TestGrid(uint32_t ReferenceFrequency, uint16_t R, uint8_t ReferenceDivisionType, uint32_t ChannelStep, uint64_t GridStep) {
+  HostBus.reset();
+  HostBus.Logging = false;
+  MAX2870 vfo;
+  vfo.init(10, 8, false, 9, false);
+  HOST_CHECK_EQUAL(MAX2870_ERROR_NONE, vfo.setrf(ReferenceFrequency, R, ReferenceDivisionType));
+  HOST_CHECK_EQUAL(MAX2870_ERROR_NONE, vfo.SetStepFreq(ChannelStep));
+  uint64_t GridStart = ((23437500ULL + GridStep - 1) / GridStep) * GridStep;
+  unsigned long Failures = 0;
+  for (uint64_t Frequency = GridStart; Frequency <= 6000000000ULL && Failures < 10; Frequency += GridStep) {
+    int ErrorCode = vfo.setf(Frequency, 4, 0, MAX2870_AUX_DIVIDED, false, 0, 0);
+    DecodedRegisters Decoded = Decode(HostBus.Registers);
+    int64_t Error = ReferenceError(Decoded, ReferenceFrequency, Frequency, 1);
+    __int128 Numerator;
+    __int128 Denominator;
+    FrequencyOffset(Decoded, ReferenceFrequency, Frequency, 1, Numerator, Denominator);
+    if (ErrorCode != MAX2870_ERROR_NONE || Numerator != 0 || Error != 0 || vfo.ReadFrequencyError() != 0) {
+      printf("grid %llu Hz (reference %lu Hz/%u step %lu Hz): error code %d frequency error %ld reference error %lld\n", (unsigned long long)Frequency,
+             (unsigned long)ReferenceFrequency, R, (unsigned long)ChannelStep, ErrorCode, (long)vfo.ReadFrequencyError(), (long long)Error);
+      Failures++;
+    }
+    CheckRegisterRanges(Decoded, Frequency);
+    uint32_t Registers[6];
+    for (int i = 0; i < 6; i++) {
+      Registers[i] = HostBus.Registers[i];
+    }
+    HOST_CHECK_EQUAL(MAX2870_ERROR_NONE, vfo.setfMilliHz((Frequency * 1000), 4, 0, MAX2870_AUX_DIVIDED, false, 0, 0));
+    for (int i = 0; i < 6; i++) {
+      HOST_CHECK_EQUAL(Registers[i], HostBus.Registers[i]);
+    }
+  }
+  HOST_CHECK_EQUAL(0, Failures);
+}
+
+// frequencies whose channel step MOD is beyond 4095 after the GCD - the reported error must be the error of the registers written
+static void TestInexact(uint32_t ReferenceFrequency, uint16_t R, uint32_t ChannelStep, uint32_t Seed, int Count) {
+  HostBus.reset();
+  HostBus.Logging = false;
+  MAX2870 vfo;
+  vfo.init(10, 8, false, 9, false);
+  HOST_CHECK_EQUAL(MAX2870_ERROR_NONE, vfo.setrf(ReferenceFrequency, R, MAX2870_REF_UNDIVIDED));
+  HOST_CHECK_EQUAL(MAX2870_ERROR_NONE, vfo.SetStepFreq(ChannelStep));
+  uint64_t State = Seed;
+  unsigned long Failures = 0;
+  unsigned long Inexact = 0;
+  for (int i = 0; i < Count && Failures < 10; i++) {
+    State = (State * 6364136223846793005ULL) + 1442695040888963407ULL;
+    uint64_t Frequency = 23437500ULL + ((State >> 16) % (6000000000ULL - 23437500ULL));
+    Frequency -= (Frequency % ChannelStep);
+    if (Frequency < 23437500ULL) {
+      Frequency += ChannelStep;
+    }
+    int ErrorCode = vfo.setf(Frequency, 4, 0, MAX2870_AUX_DIVIDED, false, 0, 0);
+    DecodedRegisters Decoded = Decode(HostBus.Registers);
+    int64_t Error = ReferenceError(Decoded, ReferenceFrequency, Frequency, 1);
+    int ExpectedCode = ((Error == 0) ? MAX2870_ERROR_NONE : MAX2870_WARNING_FREQUENCY_ERROR);
+    if (Error != 0) {
+      Inexact++;
+    }
+    if (ErrorCode != ExpectedCode || vfo.ReadFrequencyError() != Error) {
+      printf("%llu Hz (reference %lu Hz/%u step %lu Hz): error code %d frequency error %ld reference error %lld\n", (unsigned long long)Frequency,
+             (unsigned long)ReferenceFrequency, R, (unsigned long)ChannelStep, ErrorCode, (long)vfo.ReadFrequencyError(), (long long)Error);
+      Failures++;
+    }
+    CheckRegisterRanges(Decoded, Frequency);
+  }
+  HOST_CHECK_EQUAL(0, Failures);
+  HOST_CHECK(Inexact > 0);
+}
+
+int main() {
+  TestGrid(10000000UL, 1, MAX2870_REF_UNDIVIDED, 12500UL, 100000ULL);
+  TestGrid(10000000UL, 1, MAX2870_REF_UNDIVIDED, 100000UL, 1000000ULL);
+  TestGrid(25000000UL, 1, MAX2870_REF_UNDIVIDED, 25000UL, 1000000ULL);
+  TestGrid(10000000UL, 1, MAX2870_REF_DOUBLE, 10000UL, 1010000ULL);
+  TestGrid(100000000UL, 4, MAX2870_REF_HALF, 12500UL, 3750000ULL);
+  TestInexact(10000000UL, 1, 1, 1, 20000);
+  TestInexact(19200000UL, 1, 1, 2, 20000);
+  TestInexact(30000000UL, 3, 10, 3, 20000);
+  return HOST_TEST_RESULT();
+}
@@ -0,0 +1,157 @@
+/*!
+   @file test_setffast.cpp
+
+   This is part of the host (Linux) build of the Arduino Library for the MAX2870 PLL wideband frequency synthesier
+
+   Checks that setfFast() latches only R0 on the bus for a hop within the same RF divider band once the channel step MOD
+   is in R1, that a hop to another band also writes R4 (and R1 after setf() has written a reduced MOD) with R0 last, and
+   that every frequency it writes is exact with the unreduced channel step MOD - the simulated bus time of a hop
+   (HostBus.h timing model) is printed against a full setf(), and that setfFast() after setrf() writes the lock detect
+   speed (LDS) and band select clock divider (BS) of the new PFD on either side of the 32 MHz LDS boundary
+
+*/
+
+#include <MAX2870.h>
+#include "HostTest.h"
+#include "HostReference.h"
+
+const uint32_t ReferenceFrequency = 10000000UL;
+const uint32_t ChannelStep = 12500UL;
+const uint32_t ChannelMod = (ReferenceFrequency / ChannelStep);
+
+static void CheckExact(MAX2870 &vfo, uint64_t Frequency, uint32_t RfDivider) {
+  DecodedRegisters Decoded = Decode(HostBus.Registers);
+  __int128 Numerator;
+  __int128 Denominator;
+  FrequencyOffset(Decoded, ReferenceFrequency, Frequency, 1, Numerator, Denominator);
+  HOST_CHECK(Numerator == 0);
+  HOST_CHECK_EQUAL(ChannelMod, Decoded.Mod);
+  HOST_CHECK_EQUAL(RfDivider, Decoded.RfDivider);
+  HOST_CHECK_EQUAL(0, vfo.ReadFrequencyError());
+}
+
+static uint32_t RfDividerOf(uint64_t Frequency) {
+  uint32_t RfDivider = 1;
+  while ((Frequency * RfDivider) < 3000000000ULL && RfDivider < 128) {
+    RfDivider *= 2;
+  }
+  return RfDivider;
+}
+
+// setrf() to a PFD above 32 MHz (a different R) and back with only setfFast() retuning - LDS and BS must follow the PFD
+static void TestPFDChange() {
+  HostBus.reset();
+  MAX2870 vfo;
+  vfo.init(10, 8, false, 9, false);
+  HOST_CHECK_EQUAL(MAX2870_ERROR_NONE, vfo.setrf(ReferenceFrequency, 1, MAX2870_REF_UNDIVIDED));
+  HOST_CHECK_EQUAL(MAX2870_ERROR_NONE, vfo.SetStepFreq(ChannelStep));
+  HOST_CHECK_EQUAL(MAX2870_ERROR_NONE, vfo.setf((uint64_t)2400012500ULL, 4, 0, MAX2870_AUX_DIVIDED, false, 0, 0));
+  HOST_CHECK_EQUAL(0, MAX2870Field_LDS::Read(HostBus.Registers));
+  const uint32_t PFDs[3] = {40000000UL, 10000000UL, 40000000UL};
+  const uint16_t Rs[3] = {2, 1, 2};
+  for (int i = 0; i < 3; i++) {
+    HOST_CHECK_EQUAL(MAX2870_ERROR_NONE, vfo.setrf((PFDs[i] * Rs[i]), Rs[i], MAX2870_REF_UNDIVIDED));
+    HOST_CHECK_EQUAL(MAX2870_ERROR_NONE, vfo.setfFast(2400025000ULL));
+    DecodedRegisters Decoded = Decode(HostBus.Registers);
+    __int128 Numerator;
+    __int128 Denominator;
+    FrequencyOffset(Decoded, (PFDs[i] * Rs[i]), 2400025000ULL, 1, Numerator, Denominator);
+    HOST_CHECK(Numerator == 0);
+    HOST_CHECK_EQUAL(Rs[i], Decoded.R);
+    HOST_CHECK_EQUAL((PFDs[i] > 32000000UL ? 1 : 0), MAX2870Field_LDS::Read(HostBus.Registers));
+    HOST_CHECK_EQUAL((PFDs[i] / MAX2870_BAND_SELECT_CLOCK_MAX), (MAX2870Field_BS::Read(HostBus.Registers) | (MAX2870Field_BS_MSB::Read(HostBus.Registers) << 8)));
+    for (int j = 0; j < 6; j++) {
+      HOST_CHECK_EQUAL(vfo.MAX2870_R[j], HostBus.Registers[j]);
+    }
+  }
+}
+
+int main() {
+  HostBus.reset();
+  MAX2870 vfo;
+  vfo.init(10, 8, false, 9, false);
+  HOST_CHECK_EQUAL(MAX2870_ERROR_NONE, vfo.setrf(ReferenceFrequency, 1, MAX2870_REF_UNDIVIDED));
+  HOST_CHECK_EQUAL(MAX2870_ERROR_NONE, vfo.SetStepFreq(ChannelStep));
+
+  // setf() reduces FRAC/MOD (800 to 400 here) so the first setfFast() has to write the channel step MOD in R1
+  uint64_t StartTime = HostBus.Now;
+  HOST_CHECK_EQUAL(MAX2870_ERROR_NONE, vfo.setf((uint64_t)2400012500ULL, 4, 0, MAX2870_AUX_DIVIDED, false, 0, 0));
+  uint64_t SetfTime = (HostBus.Now - StartTime);
+  uint8_t SetfRegisters = vfo.MAX2870_RegsWrittenCount;
+  HOST_CHECK(Decode(HostBus.Registers).Mod != ChannelMod);
+  size_t Event = HostBus.Events.size();
+  HOST_CHECK_EQUAL(MAX2870_ERROR_NONE, vfo.setfFast(2400025000ULL));
+  std::vector<uint32_t> Words = HostBus.wordsSince(Event);
+  HOST_CHECK_EQUAL(2, Words.size());
+  HOST_CHECK_EQUAL(2, vfo.MAX2870_RegsWrittenCount);
+  if (Words.size() == 2) {
+    HOST_CHECK_EQUAL(vfo.MAX2870_R[1], Words[0]);
+    HOST_CHECK_EQUAL(vfo.MAX2870_R[0], Words[1]);
+  }
+  CheckExact(vfo, 2400025000ULL, 2);
+
+  // hops within the 1.5 to 3 GHz band - R0 only
+  uint64_t State = 1;
+  uint64_t HopTime = 0;
+  uint64_t MaximumHopTime = 0;
+  unsigned long Failures = 0;
+  const int Hops = 2000;
+  for (int i = 0; i < Hops; i++) {
+    State = (State * 6364136223846793005ULL) + 1442695040888963407ULL;
+    uint64_t Frequency = 1500000000ULL + ChannelStep + (((State >> 16) % ((1500000000ULL / ChannelStep) - 1)) * ChannelStep);
+    Event = HostBus.Events.size();
+    StartTime = HostBus.Now;
+    HOST_CHECK_EQUAL(MAX2870_ERROR_NONE, vfo.setfFast(Frequency));
+    uint64_t Elapsed = (HostBus.Now - StartTime);
+    HopTime += Elapsed;
+    if (Elapsed > MaximumHopTime) {
+      MaximumHopTime = Elapsed;
+    }
+    Words = HostBus.wordsSince(Event);
+    bool SameFrequency = (Words.size() == 0 && vfo.MAX2870_RegsWrittenCount == 0 && HostBus.Registers[0] == vfo.MAX2870_R[0]);
+    bool R0Only = (Words.size() == 1 && vfo.MAX2870_RegsWrittenCount == 1 && Words[0] == vfo.MAX2870_R[0]);
+    if (!SameFrequency && !R0Only) {
+      printf("hop to %llu Hz: %lu words written\n", (unsigned long long)Frequency, (unsigned long)Words.size());
+      Failures++;
+    }
+    CheckExact(vfo, Frequency, 2);
+  }
+  HOST_CHECK_EQUAL(0, Failures);
+
+  // a hop to another band writes R4 (RF divider) before R0
+  Event = HostBus.Events.size();
+  HOST_CHECK_EQUAL(MAX2870_ERROR_NONE, vfo.setfFast(1000012500ULL));
+  Words = HostBus.wordsSince(Event);
+  HOST_CHECK_EQUAL(2, Words.size());
+  if (Words.size() == 2) {
+    HOST_CHECK_EQUAL(vfo.MAX2870_R[4], Words[0]);
+    HOST_CHECK_EQUAL(vfo.MAX2870_R[0], Words[1]);
+  }
+  CheckExact(vfo, 1000012500ULL, 4);
+
+  // random hops across every band - R0 only unless the RF divider changed and R0 is always last
+  Failures = 0;
+  uint32_t RfDivider = 4;
+  for (int i = 0; i < Hops; i++) {
+    State = (State * 6364136223846793005ULL) + 1442695040888963407ULL;
+    uint64_t Frequency = 23437500ULL + ChannelStep + (((State >> 16) % ((6000000000ULL - 23437500ULL) / ChannelStep)) * ChannelStep);
+    Event = HostBus.Events.size();
+    HOST_CHECK_EQUAL(MAX2870_ERROR_NONE, vfo.setfFast(Frequency));
+    Words = HostBus.wordsSince(Event);
+    uint32_t NewRfDivider = RfDividerOf(Frequency);
+    size_t Expected = ((NewRfDivider != RfDivider) ? 2 : 1);
+    if (Words.size() != Expected || Words.empty() || Words.back() != vfo.MAX2870_R[0]) {
+      printf("hop to %llu Hz: %lu words written - %lu expected\n", (unsigned long long)Frequency, (unsigned long)Words.size(), (unsigned long)Expected);
+      Failures++;
+    }
+    CheckExact(vfo, Frequency, NewRfDivider);
+    RfDivider = NewRfDivider;
+  }
+  HOST_CHECK_EQUAL(0, Failures);
+
+  printf("simulated bus time (nS): setf() writing %u registers %llu, setfFast() same band hop mean %llu maximum %llu\n",
+         SetfRegisters, (unsigned long long)SetfTime, (unsigned long long)(HopTime / Hops), (unsigned long long)MaximumHopTime);
+  HOST_CHECK(MaximumHopTime < SetfTime);
+  TestPFDChange();
+  return HOST_TEST_RESULT();
+}
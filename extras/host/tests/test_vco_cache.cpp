@@ -0,0 +1,188 @@
+/*!
+   @file test_vco_cache.cpp
+
+   This is part of the host (Linux) build of the Arduino Library for the MAX2870 PLL wideband frequency synthesier
+
+   Checks MAX2870_VCO_CACHE_LEARN - a VCO frequency just above a bucket edge with a PFD which is not a whole number of
+   kHz must be cached in that bucket, a write which does not retune (setPowerLevel()) must not learn, a retune without
+   readback must latch MAX2870_WARNING_FLAG_VCO_NOT_LEARNED instead of searching with the lock pin, learnVCOBand() must
+   search with the lock pin only when it is called, a bucket where neither the readback nor the lock pin finds a band must
+   be MAX2870_VCO_NOT_FOUND and not searched again on the next retune until clearVCOCache(), and MAX2870_VCO_CACHE_LEARN
+   and MAX2870_WRITE_MODE_QUEUE must refuse each other
+
+*/
+
+#include <MAX2870.h>
+#include "HostTest.h"
+
+const uint8_t UnconnectedPin = 13;
+
+static unsigned long WordsTo(size_t Event, uint8_t Address) {
+  unsigned long Count = 0;
+  std::vector<uint32_t> Words = HostBus.wordsSince(Event);
+  for (size_t i = 0; i < Words.size(); i++) {
+    if ((Words[i] & 0x07) == Address) {
+      Count++;
+    }
+  }
+  return Count;
+}
+
+static void Setup(MAX2870 &vfo, bool LockPinUsed) {
+  HostBus.reset();
+  vfo.init(10, 8, LockPinUsed, 9, false);
+  HOST_CHECK_EQUAL(MAX2870_ERROR_NONE, vfo.setrf(10000000UL, 3, MAX2870_REF_UNDIVIDED));
+  HOST_CHECK_EQUAL(MAX2870_ERROR_NONE, vfo.setVCOCache(MAX2870_VCO_CACHE_LEARN));
+}
+
+// PFD 3.333 MHz - 1209 3/8 * PFD is exactly 4031.25 MHz, the start of bucket 22, and 4030.846 MHz from the PFD in kHz
+static void TestBucketEdge() {
+  MAX2870 vfo;
+  Setup(vfo, false);
+  HostBus.Readback = (0x00000006 | (17UL << 3)); // VAS state machine done with VCO band 17
+  HOST_CHECK_EQUAL(MAX2870_ERROR_NONE, vfo.setfDirect(3, 1209, 8, 3, 1, true));
+  uint8_t Cache[MAX2870_VCO_CACHE_SIZE];
+  vfo.exportVCOCache(Cache);
+  HOST_CHECK_EQUAL(17, Cache[22]);
+  HOST_CHECK_EQUAL(MAX2870_VCO_UNKNOWN, Cache[21]);
+  HOST_CHECK_EQUAL(1, MAX2870Field_VAS_SHDN::Read(HostBus.Registers));
+  HOST_CHECK_EQUAL(17, MAX2870Field_VCO::Read(HostBus.Registers));
+
+  // just below the edge is in bucket 21
+  vfo.clearVCOCache();
+  HostBus.Readback = (0x00000006 | (16UL << 3));
+  HOST_CHECK_EQUAL(MAX2870_ERROR_NONE, vfo.setfDirect(3, 1209, 4095, 1535, 1, true)); // 4031.2495 MHz
+  vfo.exportVCOCache(Cache);
+  HOST_CHECK_EQUAL(16, Cache[21]);
+  HOST_CHECK_EQUAL(MAX2870_VCO_UNKNOWN, Cache[22]);
+}
+
+// no readback and no lock pin - nothing can be learned, so only a retune may try
+static void TestRetuneOnly() {
+  MAX2870 vfo;
+  Setup(vfo, false);
+  HostBus.ReadbackPin = UnconnectedPin;
+  size_t Event = HostBus.Events.size();
+  HOST_CHECK_EQUAL(MAX2870_ERROR_NONE, vfo.setfDirect(1, 400, 2, 1, 1, true));
+  HOST_CHECK(WordsTo(Event, 6) != 0); // readback tried
+  HOST_CHECK_EQUAL(MAX2870_WARNING_FLAG_VCO_NOT_LEARNED, vfo.readWarnings());
+  HOST_CHECK_EQUAL(0, vfo.readWarnings()); // cleared when read
+  uint8_t Cache[MAX2870_VCO_CACHE_SIZE];
+  vfo.exportVCOCache(Cache);
+  for (int i = 0; i < MAX2870_VCO_CACHE_SIZE; i++) {
+    HOST_CHECK_EQUAL(MAX2870_VCO_UNKNOWN, Cache[i]);
+  }
+  Event = HostBus.Events.size();
+  HOST_CHECK_EQUAL(MAX2870_ERROR_NONE, vfo.setPowerLevel(2));
+  std::vector<uint32_t> Words = HostBus.wordsSince(Event);
+  HOST_CHECK_EQUAL(1, Words.size());
+  HOST_CHECK_EQUAL(vfo.MAX2870_R[4], HostBus.Registers[4]);
+  HOST_CHECK_EQUAL(0, vfo.readWarnings());
+  Event = HostBus.Events.size();
+  HOST_CHECK_EQUAL(MAX2870_ERROR_NONE, vfo.setfDirect(1, 401, 2, 1, 1, true));
+  HOST_CHECK(WordsTo(Event, 6) != 0); // a retune tries again
+  HOST_CHECK_EQUAL(MAX2870_WARNING_FLAG_VCO_NOT_LEARNED, vfo.readWarnings());
+  HOST_CHECK_EQUAL(MAX2870_ERROR_LOCK_PIN_UNUSED, vfo.learnVCOBand());
+}
+
+// the VAS state machine never finishes on the readback
+static void TestReadbackNotFound() {
+  MAX2870 vfo;
+  Setup(vfo, false);
+  HostBus.Readback = (0x00000006 | (1UL << 9));
+  size_t Event = HostBus.Events.size();
+  HOST_CHECK_EQUAL(MAX2870_ERROR_NONE, vfo.setfDirect(3, 1300, 8, 1, 1, true));
+  HOST_CHECK(WordsTo(Event, 6) != 0);
+  uint8_t Cache[MAX2870_VCO_CACHE_SIZE];
+  vfo.exportVCOCache(Cache);
+  uint8_t Bucket = ((((10000000ULL * 10401ULL) / 24ULL) - 3000000000ULL) / (MAX2870_VCO_BUCKET_WIDTH * 1000ULL));
+  HOST_CHECK_EQUAL(MAX2870_VCO_NOT_FOUND, Cache[Bucket]);
+  HOST_CHECK_EQUAL(0, MAX2870Field_VAS_SHDN::Read(HostBus.Registers));
+
+  // a retune to the same bucket is not searched again
+  Event = HostBus.Events.size();
+  HOST_CHECK_EQUAL(MAX2870_ERROR_NONE, vfo.setfDirect(3, 1300, 8, 2, 1, true));
+  HOST_CHECK_EQUAL(0, WordsTo(Event, 6));
+  HOST_CHECK_EQUAL(vfo.MAX2870_R[0], HostBus.Registers[0]);
+  HOST_CHECK_EQUAL(0, MAX2870Field_VAS_SHDN::Read(HostBus.Registers));
+
+  // importVCOCache() and clearVCOCache() make it unknown again
+  vfo.importVCOCache(Cache);
+  vfo.exportVCOCache(Cache);
+  HOST_CHECK_EQUAL(MAX2870_VCO_UNKNOWN, Cache[Bucket]);
+  HostBus.Readback = (0x00000006 | (40UL << 3));
+  Event = HostBus.Events.size();
+  HOST_CHECK_EQUAL(MAX2870_ERROR_NONE, vfo.setfDirect(3, 1300, 8, 3, 1, true));
+  HOST_CHECK(WordsTo(Event, 6) != 0);
+  vfo.exportVCOCache(Cache);
+  HOST_CHECK_EQUAL(40, Cache[Bucket]);
+}
+
+// no readback and the lock pin never goes high - a retune does not search, learnVCOBand() tries every band once
+static void TestLockPinNotFound() {
+  MAX2870 vfo;
+  Setup(vfo, true);
+  HostBus.ReadbackPin = UnconnectedPin;
+  size_t Event = HostBus.Events.size();
+  HOST_CHECK_EQUAL(MAX2870_ERROR_NONE, vfo.setfDirect(1, 400, 2, 1, 1, true));
+  HOST_CHECK(WordsTo(Event, 3) < MAX2870_VCO_BANDS);
+  HOST_CHECK_EQUAL(MAX2870_WARNING_FLAG_VCO_NOT_LEARNED, vfo.readWarnings());
+  uint8_t Cache[MAX2870_VCO_CACHE_SIZE];
+  vfo.exportVCOCache(Cache);
+  HOST_CHECK_EQUAL(MAX2870_VCO_UNKNOWN, Cache[21]); // 4005 MHz
+  Event = HostBus.Events.size();
+  HOST_CHECK_EQUAL(MAX2870_ERROR_VCO_NOT_FOUND, vfo.learnVCOBand());
+  HOST_CHECK(WordsTo(Event, 3) >= MAX2870_VCO_BANDS);
+  vfo.exportVCOCache(Cache);
+  HOST_CHECK_EQUAL(MAX2870_VCO_NOT_FOUND, Cache[21]);
+  HOST_CHECK_EQUAL(0, MAX2870Field_VAS_SHDN::Read(HostBus.Registers));
+  Event = HostBus.Events.size();
+  HOST_CHECK_EQUAL(MAX2870_ERROR_NONE, vfo.setfDirect(1, 400, 4, 3, 1, true)); // 4007.5 MHz
+  HOST_CHECK_EQUAL(0, WordsTo(Event, 3));
+  HOST_CHECK_EQUAL(0, WordsTo(Event, 6));
+  HOST_CHECK_EQUAL(0, vfo.readWarnings());
+  vfo.clearVCOCache();
+  Event = HostBus.Events.size();
+  HOST_CHECK_EQUAL(MAX2870_ERROR_VCO_NOT_FOUND, vfo.learnVCOBand());
+  HOST_CHECK(WordsTo(Event, 3) >= MAX2870_VCO_BANDS);
+}
+
+// no readback and the lock pin is always high - every band locks so the middle band is cached
+static void TestLockPinFound() {
+  MAX2870 vfo;
+  Setup(vfo, true);
+  HostBus.ReadbackPin = UnconnectedPin;
+  HostBus.pinWrite(8, HIGH);
+  HOST_CHECK_EQUAL(MAX2870_ERROR_NONE, vfo.setfDirect(1, 400, 2, 1, 1, true));
+  HOST_CHECK_EQUAL(MAX2870_ERROR_NONE, vfo.learnVCOBand());
+  uint8_t Cache[MAX2870_VCO_CACHE_SIZE];
+  vfo.exportVCOCache(Cache);
+  HOST_CHECK_EQUAL((MAX2870_VCO_BANDS - 1) / 2, Cache[21]);
+  HOST_CHECK_EQUAL(1, MAX2870Field_VAS_SHDN::Read(HostBus.Registers));
+  HOST_CHECK_EQUAL((MAX2870_VCO_BANDS - 1) / 2, MAX2870Field_VCO::Read(HostBus.Registers));
+  HOST_CHECK_EQUAL(vfo.MAX2870_R[0], HostBus.Registers[0]);
+}
+
+// learning cannot follow queued writes (and there is no readback under MAX2870_WRITE_MODE_QUEUE)
+static void TestQueueRefused() {
+  MAX2870 vfo;
+  Setup(vfo, true);
+  HOST_CHECK_EQUAL(MAX2870_ERROR_VCO_CACHE_WRITE_MODE, vfo.setWriteMode(MAX2870_WRITE_MODE_QUEUE));
+  HOST_CHECK_EQUAL(MAX2870_ERROR_NONE, vfo.setVCOCache(MAX2870_VCO_CACHE_ON));
+  HOST_CHECK_EQUAL(MAX2870_ERROR_NONE, vfo.setWriteMode(MAX2870_WRITE_MODE_QUEUE));
+  HOST_CHECK_EQUAL(MAX2870_ERROR_VCO_CACHE_WRITE_MODE, vfo.setVCOCache(MAX2870_VCO_CACHE_LEARN));
+  HOST_CHECK_EQUAL(MAX2870_ERROR_VCO_CACHE_WRITE_MODE, vfo.learnVCOBand());
+  HOST_CHECK_EQUAL(MAX2870_ERROR_NONE, vfo.setVCOCache(MAX2870_VCO_CACHE_OFF));
+  HOST_CHECK_EQUAL(MAX2870_ERROR_NONE, vfo.setWriteMode(MAX2870_WRITE_MODE_REGISTER));
+  HOST_CHECK_EQUAL(MAX2870_ERROR_VCO_CACHE_MODE, vfo.learnVCOBand());
+}
+
+int main() {
+  TestBucketEdge();
+  TestRetuneOnly();
+  TestReadbackNotFound();
+  TestLockPinNotFound();
+  TestLockPinFound();
+  TestQueueRefused();
+  return HOST_TEST_RESULT();
+}
@@ -10,13 +10,25 @@
 #include <Arduino.h>
 #include <SPI.h>
 #include <stdint.h>
-#include <BigNumber.h>
-#include <BitFieldManipulation.h>
-#include <BeyondByte.h>
+#include "MAX2870Fields.h"
+#include "MAX2870Transport.h"
+
+#if defined(__AVR__)
+#include <avr/pgmspace.h>
+#define MAX2870_ReadFlashDword(address) pgm_read_dword(address)
+#define MAX2870_ReadFlashWord(address) pgm_read_word(address)
+#else // flash is in the same address space as RAM
+#ifndef PROGMEM
+#define PROGMEM
+#endif
+#define MAX2870_ReadFlashDword(address) (*(address))
+#define MAX2870_ReadFlashWord(address) (*(address))
+#endif
 
 #define MAX2870_PFD_MAX   105000000UL      ///< Maximum Frequency for Phase Detector (Integer-N)
 #define MAX2870_PFD_MAX_FRAC   50000000UL  ///< Maximum Frequency for Phase Detector (Fractional-N)
 #define MAX2870_PFD_MIN   125000UL        ///< Minimum Frequency for Phase Detector
+#define MAX2870_BAND_SELECT_CLOCK_MAX   50000UL   ///< Maximum Frequency for the VCO Band Select Clock
 #define MAX2870_REFIN_MAX   200000000UL   ///< Maximum Reference Frequency
 #define MAX2870_REFIN_MIN   10000000UL   ///< Minimum Reference Frequency
 #define MAX2870_REF_FREQ_DEFAULT 10000000UL  ///< Default Reference Frequency
@@ -28,6 +40,26 @@
 #define MAX2870_REF_DOUBLE 2
 #define MAX2870_LOOP_TYPE_INVERTING 0
 #define MAX2870_LOOP_TYPE_NONINVERTING 1
+#define MAX2870_PRECISION_SEARCH_RATIONAL 0 // best rational approximation
+#define MAX2870_PRECISION_SEARCH_LINEAR 1 // reference search through every MOD value
+#define MAX2870_WRITE_MODE_REGISTER 0 // one SPI transaction for each register
+#define MAX2870_WRITE_MODE_BURST 1 // one SPI transaction for all registers
+#define MAX2870_WRITE_MODE_QUEUE 2 // registers are queued and written by serviceQueue() in one SPI transaction
+#define MAX2870_VCO_CACHE_OFF 0 // the VAS state machine selects the VCO band on every retune
+#define MAX2870_VCO_CACHE_ON 1 // the cached VCO band is written with the VAS state machine disabled when the VCO frequency has a cached band
+#define MAX2870_VCO_CACHE_LEARN 2 // as MAX2870_VCO_CACHE_ON with the VCO band found and cached after a retune to a VCO frequency without a cached band
+#define MAX2870_FAST_LOCK_OFF 0
+#define MAX2870_FAST_LOCK_HARDWARE 1 // the MAX2870 raises the charge pump current (and shorts SW) for the timeout after each R0 write
+#define MAX2870_FAST_LOCK_SOFTWARE 2 // R2 is written with the boost charge pump current with each R0 write and restored by serviceFastLock() after the timeout
+#define MAX2870_PLAYBACK_ORDER_SEQUENTIAL 0
+#define MAX2870_PLAYBACK_ORDER_RANDOM 1 // pseudo-random order from a maximal length LFSR with every step written once in each pass
+#define MAX2870_ADC_OFF 0
+#define MAX2870_ADC_TEMPERATURE 1 // temperature sensor
+#define MAX2870_ADC_TUNE_VOLTAGE 4 // VCO tuning voltage
+#define MAX2870_LOCK_STATUS_IDLE 0 // no lock time is being measured
+#define MAX2870_LOCK_STATUS_WAITING 1 // R0 has been written and the LD pin is not yet high
+#define MAX2870_LOCK_STATUS_LOCKED 2 // lock time measured - MAX2870_LockTime
+#define MAX2870_LOCK_STATUS_TIMEOUT 3 // the LD pin did not go high within MAX2870_LOCK_TIMEOUT
 
 // common to all of the following subroutines
 #define MAX2870_ERROR_NONE 0
@@ -63,13 +95,132 @@
 // setPDpolarity
 #define MAX2870_ERROR_POLARITY_INVALID 21
 
+// setPrecisionSearch
+#define MAX2870_ERROR_PRECISION_SEARCH_INVALID 22
+
+// setWriteMode
+#define MAX2870_ERROR_WRITE_MODE_INVALID 23
+
+// planSweep
+#define MAX2870_ERROR_SWEEP_RANGE 24
+
+// startPlayback
+#define MAX2870_ERROR_PLAYBACK_LENGTH 25
+
+// ReadLockStatistics
+#define MAX2870_ERROR_LOCK_BAND 26
+
+// waitForLock
+#define MAX2870_ERROR_LOCK_PIN_UNUSED 27
+#define MAX2870_ERROR_LOCK_TIMEOUT 28
+
+// setVCOCache
+#define MAX2870_ERROR_VCO_CACHE_MODE 29
+
+// readStatusRegister
+#define MAX2870_ERROR_READBACK 30
+
+// setADCMode
+#define MAX2870_ERROR_ADC_MODE 31
+
+// setFastLock
+#define MAX2870_ERROR_FAST_LOCK_MODE 32
+#define MAX2870_ERROR_FAST_LOCK_TIMEOUT 33
+
+// setPlaybackOrder
+#define MAX2870_ERROR_PLAYBACK_ORDER 34
+
+// startPlayback, setWriteMode, setVCOCache
+#define MAX2870_ERROR_PLAYBACK_WRITE_MODE 35
+
+// WriteRegs, WriteAllRegs and every function which writes registers under MAX2870_WRITE_MODE_QUEUE
+#define MAX2870_ERROR_QUEUE_FULL 36
+
+// setFastLock, setWriteMode
+#define MAX2870_ERROR_FAST_LOCK_WRITE_MODE 37
+
+// setVCOCache, setWriteMode, learnVCOBand
+#define MAX2870_ERROR_VCO_CACHE_WRITE_MODE 38
+
+// learnVCOBand
+#define MAX2870_ERROR_VCO_NOT_FOUND 39
+
+// readWarnings - latched until read
+#define MAX2870_WARNING_FLAG_VCO_NOT_LEARNED 0x01 // a retune under MAX2870_VCO_CACHE_LEARN could not be learned without readback - see learnVCOBand()
+#define MAX2870_WARNING_FLAG_BAND_SELECT_CLAMPED 0x02 // the band select clock divider was clamped to 1023 - the band select clock is above MAX2870_BAND_SELECT_CLOCK_MAX (PFD above 51.15 MHz)
+
 #define MAX2870_RegsToWrite 6UL // for high speed sweep
+#define MAX2870_SWEEP_RING_SIZE 4 // steps calculated ahead of the current step by startSweep()/serviceSweep()
+#define MAX2870_QUEUE_SIZE 4 // register sets which can be queued under MAX2870_WRITE_MODE_QUEUE
+#define MAX2870_LOCK_BANDS 8 // lock time statistics for each RF divider (band n is the RF divider of 2^n)
+#define MAX2870_LOCK_HISTOGRAM_BINS 8
+#define MAX2870_LOCK_HISTOGRAM_FIRST_BIN 32UL // uS - each following bin is twice as wide and the last bin is for all longer lock times
+#define MAX2870_LOCK_TIMEOUT 10000UL // uS
+#define MAX2870_VCO_CACHE_SIZE 64 // VCO frequency buckets from 3 to 6 GHz
+#define MAX2870_VCO_BUCKET_WIDTH 46875UL // kHz
+#define MAX2870_VCO_UNKNOWN 0xFF // no cached VCO band
+#define MAX2870_VCO_NOT_FOUND 0xFE // no VCO band found by learning - not searched again until clearVCOCache()/importVCOCache()
+#define MAX2870_VCO_BANDS 64 // VCO and sub-band
+#define MAX2870_VCO_LEARN_DELAY 20 // uS after each VCO band is tried before the LD pin is read
+#define MAX2870_VCO_LEARN_TIMEOUT 1000UL // uS for the readback and for each VCO band tried by learnVCOBand()
+#define MAX2870_FAST_LOCK_DIVIDER_MAX 4095 // clock divider (CDIV) for the fast lock timeout
 
 // ReadCurrentFrequency
 #define MAX2870_DIGITS 10
 #define MAX2870_DECIMAL_PLACES 6
 #define MAX2870_ReadCurrentFrequency_ArraySize (MAX2870_DIGITS + MAX2870_DECIMAL_PLACES + 2) // including decimal point and null terminator
 
+typedef void (*MAX2870QueueCallback)(uint16_t Sequence); // called by serviceQueue() after a queued register set has been written
+
+/*!
+   @brief one step of a compact sweep table (6 bytes per step instead of 24)
+
+   R1/R2/R3/R4/R5 other than MOD, the RF divider select and the integer/fractional mode bits
+   are taken from the current registers when the step is written
+*/
+struct MAX2870CompactStep {
+  uint32_t R0; // INT, FRAC and integer-n mode as written to R0
+  uint16_t ModDivider; // MOD (bits 0-11) and RF divider select (bits 12-14)
+};
+
+/*!
+   @brief R6 as read back from MUXOUT by readStatusRegister()
+*/
+struct MAX2870Status {
+  uint32_t Register; // R6 as read
+  uint8_t Die; // die revision
+  bool PowerOnReset;
+  uint8_t ADC; // ADC result as set by setADCMode()
+  bool ADCValid;
+  bool VASActive; // VCO band search in progress
+  uint8_t VCO; // current VCO band
+};
+
+/*!
+   @brief playback statistics since the start of playback as returned by ReadPlaybackStatistics() - times in uS
+*/
+struct MAX2870PlaybackStatistics {
+  uint32_t StepsWritten;
+  int32_t MinimumJitter; // measured step to step time against the dwell time of the previous step
+  int32_t MaximumJitter;
+  uint32_t MinimumWriteTime; // from the start of the tick to the last register of the step
+  uint32_t MeanWriteTime;
+  uint32_t MaximumWriteTime;
+  uint32_t RegistersWritten;
+};
+
+/*!
+   @brief lock time statistics of one RF divider band as returned by ReadLockStatistics() - times in uS
+*/
+struct MAX2870LockStatistics {
+  uint32_t Locks; // lock times measured
+  uint32_t Timeouts;
+  uint32_t Minimum;
+  uint32_t Mean;
+  uint32_t Maximum;
+  uint16_t Histogram[MAX2870_LOCK_HISTOGRAM_BINS]; // bin 0 is below MAX2870_LOCK_HISTOGRAM_FIRST_BIN - counts stop at 65535
+};
+
 /*!
    @brief MAX2870 chip device driver
 
@@ -89,23 +240,23 @@
    register settings. While a number of checks are provided in the library,
    not all values are checked for allowed settings, so YMMV.
 
+   The registers are sent through Transport (see MAX2870Transport.h), which is
+   fixed at compile time - MAX2870 is the driver on the hardware SPI.
+
 */
-class MAX2870
+template <class Transport = MAX2870HardwareSPI>
+class MAX2870Device
 {
   public:
     /*!
        Constructor
-       creates an object and sets the SPI parameters.
-       see the Arduino SPI library for the parameter values.
-       @param pin the SPI Slave Select Pin to use
-       @param mode the SPI Mode (see SPI mode define values)
-       @param speed the SPI Serial Speed (see SPI speed values)
-       @param order the SPI bit order (see SPI bit order values)
+       creates an object with a default constructed transport, or a copy of RegisterTransport
+       for transports which are constructed with their pins - the SS pin is set by init()
     */
-    uint8_t MAX2870_PIN_SS = 10;   ///< Ard Pin for SPI Slave Select
-
-    MAX2870();
-    void WriteRegs();
+    MAX2870Device();
+    explicit MAX2870Device(const Transport &RegisterTransport);
+    int WriteRegs(); // only registers which have changed since they were last written
+    int WriteAllRegs();
 
     uint16_t ReadR();
     uint16_t ReadInt();
@@ -120,26 +271,214 @@ class MAX2870
 
     void init(uint8_t SSpin, uint8_t LockPinNumber, bool Lock_Pin_Used, uint8_t CEpin, bool CE_Pin_Used) ;
     int SetStepFreq(uint32_t value);
-    int setf(char *freq, uint8_t PowerLevel, uint8_t AuxPowerLevel, uint8_t AuxFrequencyDivider, bool PrecisionFrequency, uint32_t FrequencyTolerance, uint32_t CalculationTimeout) ; // set freq and power levels and output mode with option for precision frequency setting with tolerance in Hz
-    void setfDirect(uint16_t R_divider, uint16_t INT_value,uint16_t MOD_value,uint16_t FRAC_value, uint8_t RF_DIVIDER_value, bool FRACTIONAL_MODE);
+    int setf(const char *freq, uint8_t PowerLevel, uint8_t AuxPowerLevel, uint8_t AuxFrequencyDivider, bool PrecisionFrequency, uint32_t FrequencyTolerance, uint32_t CalculationTimeout) ; // set freq and power levels and output mode with option for precision frequency setting with tolerance in Hz
+    int setf(uint64_t FrequencyHz, uint8_t PowerLevel, uint8_t AuxPowerLevel, uint8_t AuxFrequencyDivider, bool PrecisionFrequency, uint32_t FrequencyTolerance, uint32_t CalculationTimeout) ; // as above without string parsing
+    int setfMilliHz(uint64_t FrequencyMilliHz, uint8_t PowerLevel, uint8_t AuxPowerLevel, uint8_t AuxFrequencyDivider, bool PrecisionFrequency, uint32_t FrequencyTolerance, uint32_t CalculationTimeout) ; // as above with frequency in mHz
+    int setfFast(uint64_t FrequencyHz); // retune with only R0 written when the RF divider is unchanged
+    int setfDirect(uint16_t R_divider, uint16_t INT_value,uint16_t MOD_value,uint16_t FRAC_value, uint8_t RF_DIVIDER_value, bool FRACTIONAL_MODE);
     int setrf(uint32_t f, uint16_t r, uint8_t ReferenceDivisionType) ; // set reference freq and reference divider (default is 10 MHz with divide by 1)
     int setPowerLevel(uint8_t PowerLevel);
     int setAuxPowerLevel(uint8_t PowerLevel);
 
-    void WriteSweepValues(const uint32_t *regs);
+    int WriteSweepValues(const uint32_t *regs);
     void ReadSweepValues(uint32_t *regs);
+    int planSweep(uint64_t StartFrequency, uint64_t StopFrequency, uint64_t StepFrequency, uint32_t *regs, uint16_t MaximumSteps, uint16_t *StepsPlanned); // registers for each step without writing to the MAX2870
+    int planSweepCompact(uint64_t StartFrequency, uint64_t StopFrequency, uint64_t StepFrequency, MAX2870CompactStep *steps, uint16_t MaximumSteps, uint16_t *StepsPlanned); // as above with a compact sweep table
+    int WriteCompactSweepValues(const MAX2870CompactStep *step);
+    void ReadCompactSweepValues(MAX2870CompactStep *step);
+    int WriteSweepValues_P(const uint32_t *regs); // regs is in flash (PROGMEM)
+    int WriteCompactSweepValues_P(const MAX2870CompactStep *step); // step is in flash (PROGMEM)
+    int startSweep(uint64_t StartFrequency, uint64_t StopFrequency, uint64_t StepFrequency, uint32_t DwellTime, bool Repeat); // DwellTime in uS - each step is calculated while the previous steps dwell
+    int startSweepLocked(uint64_t StartFrequency, uint64_t StopFrequency, uint64_t StepFrequency, uint32_t SettleTime, uint32_t DwellTime, bool Repeat); // as above with each step written SettleTime uS after lock or after DwellTime uS without lock
+    int serviceSweep(); // call as often as possible while MAX2870_SweepRunning is true
+    void stopSweep();
+    int startPlayback(const uint32_t *regs, uint16_t Steps, const uint16_t *DwellTicks, uint16_t DwellTime, uint32_t TickPeriod, bool Repeat); // DwellTicks[Steps] or NULL for DwellTime ticks on every step
+    int startPlaybackCompact(const MAX2870CompactStep *steps, uint16_t Steps, const uint16_t *DwellTicks, uint16_t DwellTime, uint32_t TickPeriod, bool Repeat); // as above with a compact sweep table
+    void tick(); // call from a timer interrupt every TickPeriod uS
+    void stopPlayback();
+    void ReadPlaybackStatistics(uint32_t *StepsWritten, int32_t *MinimumJitter, int32_t *MaximumJitter); // jitter in uS
+    void ReadPlaybackStatistics(MAX2870PlaybackStatistics *Statistics); // as above with the step write time and registers written
+    int setPlaybackOrder(uint8_t Order, uint16_t Seed); // from the next startPlayback()/startPlaybackCompact() - the same Seed gives the same order
     void ReadCurrentFrequency(char *freq);
     int setCPcurrent(float Current);
     int setPDpolarity(uint8_t PDpolarity);
+    int setPrecisionSearch(uint8_t SearchType);
+    int setWriteMode(uint8_t WriteMode);
+    void serviceQueue(); // writes the oldest register set queued under MAX2870_WRITE_MODE_QUEUE - may be called from an interrupt
+    uint8_t queuedWrites();
+    void setQueueCallback(MAX2870QueueCallback Callback); // NULL for no callback
+    uint8_t serviceLock(); // call from loop() after a retune until it no longer returns MAX2870_LOCK_STATUS_WAITING
+    void lockInterrupt(); // call from a rising edge interrupt on the LD pin in place of serviceLock()
+    int ReadLockStatistics(uint8_t Band, MAX2870LockStatistics *Statistics);
+    int waitForLock(uint32_t Timeout); // uS
+    int setVCOCache(uint8_t Mode);
+    void exportVCOCache(uint8_t *Cache); // MAX2870_VCO_CACHE_SIZE bytes
+    void importVCOCache(const uint8_t *Cache);
+    void clearVCOCache();
+    int learnVCOBand(); // finds and caches the VCO band of the current VCO frequency - may take MAX2870_VCO_BANDS * MAX2870_VCO_LEARN_TIMEOUT with the lock pin
+    uint8_t readWarnings(); // MAX2870_WARNING_FLAG_* latched since the last call
+    int readStatusRegister(MAX2870Status *Status); // MUXOUT must be connected to MISO (or the MuxPin of a pin transport)
+    int setADCMode(uint8_t Mode);
+    int setFastLock(uint8_t Mode, uint32_t Timeout, float BoostCurrent); // Timeout in uS - BoostCurrent in mA for MAX2870_FAST_LOCK_SOFTWARE
+    bool serviceFastLock(); // call from the context of the register writes after a retune until it returns false
+    void clearLockStatistics();
 
-    SPISettings MAX2870_SPI;
+    Transport MAX2870_Transport;
 
     int32_t MAX2870_FrequencyError = 0;
     // power on defaults
     uint32_t MAX2870_reffreq = MAX2870_REF_FREQ_DEFAULT;
     uint32_t MAX2870_R[6] {0x007D0000, 0x2000FFF9, 0x18006E42, 0x0000000B, 0x6180B23C, 0x00400005};
     uint32_t MAX2870_ChanStep = 100000UL;
+    uint32_t MAX2870_R_Written[6] {0, 0, 0, 0, 0, 0}; // values last written to the MAX2870
+    bool MAX2870_RegsWritten = false; // MAX2870_R_Written is valid
+    uint8_t MAX2870_RegsWrittenCount = 0; // number of registers written by the last WriteRegs()
+    uint8_t MAX2870_PrecisionSearch = MAX2870_PRECISION_SEARCH_RATIONAL;
+    uint8_t MAX2870_WriteMode = MAX2870_WRITE_MODE_REGISTER;
+    bool MAX2870_SweepRunning = false;
+    uint32_t MAX2870_SweepStepsWritten = 0; // since startSweep()
+    uint32_t MAX2870_SweepUnderruns = 0; // steps which were not calculated ahead when the previous step had dwelled
+    uint32_t MAX2870_SweepLockTimeouts = 0; // steps of startSweepLocked() which were written after DwellTime without lock
+    volatile bool MAX2870_PlaybackRunning = false;
+    volatile uint32_t MAX2870_PlaybackStepsWritten = 0; // since startPlayback()/startPlaybackCompact() - more than one byte on AVR, so read it with ReadPlaybackStatistics() while playback is running
+    uint16_t MAX2870_QueueSequence = 0; // sequence number of the last queued register set
+    uint32_t MAX2870_LockTime = 0; // uS from the last R0 write to the LD pin going high
+
+  private:
+    struct SweepState { // sweep calculation carried from one step to the next
+      uint64_t Frequency; // frequency of the next step to be calculated
+      uint64_t StepFrequency;
+      uint64_t BandLimit; // highest frequency for the current RF divider
+      uint64_t PFDnumerator;
+      uint64_t StepDenominator;
+      uint64_t Remainder;
+      uint64_t RemainderIncrement;
+      uint32_t PFDdenominator;
+      uint32_t PFDFrequency;
+      uint32_t N_Int;
+      uint32_t N_IntIncrement;
+      uint32_t ChannelMod; // PFD / channel step before GCD reduction
+      uint32_t ChannelFrac;
+      uint32_t ChannelFracIncrement;
+      int32_t FrequencyError; // of the last calculated step
+      uint8_t RfDivSel;
+      bool ExactChannels;
+    };
+
+    struct QueuedWrite {
+      uint32_t Registers[MAX2870_RegsToWrite];
+      uint16_t Sequence;
+      bool AllRegisters; // WriteAllRegs()
+    };
+
+    // MAX2870_WRITE_MODE_QUEUE - single producer (WriteRegs()/WriteAllRegs()) and single consumer (serviceQueue()) with one unused slot to tell a full queue from an empty queue
+    volatile QueuedWrite MAX2870_Queue[(MAX2870_QUEUE_SIZE + 1)];
+    volatile uint8_t MAX2870_QueueHead = 0; // only changed by serviceQueue()
+    volatile uint8_t MAX2870_QueueTail = 0; // only changed by QueueRegs()
+    MAX2870QueueCallback MAX2870_QueueCallback = NULL;
+
+    struct LockBandState {
+      uint32_t Locks;
+      uint32_t Timeouts;
+      uint32_t Minimum;
+      uint32_t Maximum;
+      uint64_t Total;
+      uint16_t Histogram[MAX2870_LOCK_HISTOGRAM_BINS];
+    };
+
+    // lock time measurement - started by each R0 write when the LD pin is used
+    uint8_t MAX2870_PIN_LD = 12;
+    bool MAX2870_LockPinUsed = false;
+    volatile bool MAX2870_LockPending = false;
+    volatile uint32_t MAX2870_LockStartTime = 0;
+    volatile uint8_t MAX2870_LockBand = 0;
+    LockBandState MAX2870_LockBands[MAX2870_LOCK_BANDS] {};
+
+    // VCO band for each VCO frequency bucket, MAX2870_VCO_UNKNOWN or MAX2870_VCO_NOT_FOUND
+    uint8_t MAX2870_VCOCacheMode = MAX2870_VCO_CACHE_OFF;
+    uint8_t MAX2870_VCOCache[MAX2870_VCO_CACHE_SIZE];
+
+    uint8_t MAX2870_Warnings = 0; // MAX2870_WARNING_FLAG_* for readWarnings()
+
+    // fast lock - the charge pump current of MAX2870_FAST_LOCK_SOFTWARE is restored from MAX2870_FastLockRestoreCP by serviceFastLock()
+    uint8_t MAX2870_FastLockMode = MAX2870_FAST_LOCK_OFF;
+    uint32_t MAX2870_FastLockTimeout = 0; // uS
+    uint8_t MAX2870_FastLockBoostCP = 0;
+    uint8_t MAX2870_FastLockRestoreCP = 0;
+    bool MAX2870_FastLockPending = false;
+    uint32_t MAX2870_FastLockStartTime = 0;
+
+    // startSweep()/serviceSweep()
+    SweepState MAX2870_Sweep;
+    MAX2870CompactStep MAX2870_SweepRing[MAX2870_SWEEP_RING_SIZE];
+    uint64_t MAX2870_SweepStart;
+    uint64_t MAX2870_SweepStop;
+    uint32_t MAX2870_SweepDwell;
+    uint32_t MAX2870_SweepNextStepTime; // micros() when the current step has dwelled
+    uint32_t MAX2870_SweepSettle;
+    bool MAX2870_SweepLockGated; // startSweepLocked() with the lock pin used
+    bool MAX2870_SweepLocked; // the current step has locked
+    uint8_t MAX2870_SweepRingHead = 0;
+    uint8_t MAX2870_SweepRingCount = 0;
+    bool MAX2870_SweepRepeat = false;
+    bool MAX2870_SweepCalculated = false; // every step up to the stop frequency is in the ring
+
+    // startPlayback()/startPlaybackCompact()/tick() - only changed by tick() while MAX2870_PlaybackRunning is true - the statistics are read by ReadPlaybackStatistics() with interrupts disabled
+    const uint32_t *MAX2870_PlaybackRegs = NULL;
+    const MAX2870CompactStep *MAX2870_PlaybackSteps = NULL;
+    const uint16_t *MAX2870_PlaybackDwellTicks = NULL;
+    uint16_t MAX2870_PlaybackDwell;
+    uint16_t MAX2870_PlaybackLength;
+    uint16_t MAX2870_PlaybackIndex;
+    uint16_t MAX2870_PlaybackTicksRemaining;
+    uint16_t MAX2870_PlaybackPreviousDwell; // ticks
+    uint32_t MAX2870_PlaybackTickPeriod;
+    uint32_t MAX2870_PlaybackLastStepTime;
+    volatile int32_t MAX2870_PlaybackJitterMinimum;
+    volatile int32_t MAX2870_PlaybackJitterMaximum;
+    volatile uint32_t MAX2870_PlaybackWriteTimeMinimum;
+    volatile uint32_t MAX2870_PlaybackWriteTimeMaximum;
+    volatile uint64_t MAX2870_PlaybackWriteTimeTotal;
+    volatile uint32_t MAX2870_PlaybackRegistersWritten;
+    bool MAX2870_PlaybackRepeat;
+    uint8_t MAX2870_PlaybackOrder = MAX2870_PLAYBACK_ORDER_SEQUENTIAL; // from setPlaybackOrder()
+    uint8_t MAX2870_PlaybackRunOrder = MAX2870_PLAYBACK_ORDER_SEQUENTIAL; // of the running playback - setPlaybackOrder() during playback cannot change the order tick() follows
+    uint16_t MAX2870_PlaybackSeed = 1;
+    uint16_t MAX2870_PlaybackLFSR; // MAX2870_PLAYBACK_ORDER_RANDOM - the step index is the LFSR state - 1 with states beyond the table skipped
+    uint16_t MAX2870_PlaybackLFSRFirst; // state of the first step of each pass
+    uint16_t MAX2870_PlaybackLFSRMask;
+    uint16_t MAX2870_PlaybackLFSRTaps;
+
+    void WriteRegisterSet(const uint32_t *regs);
+    int QueueRegs(bool AllRegisters);
+    uint8_t RecordLock(uint32_t CurrentTime, bool Locked);
+    uint8_t VCOBucket(const uint32_t *regs);
+    void SetBandSelectDivider(uint32_t *regs);
+    void SetFastLockDivider(uint32_t *regs);
+    bool RetuneRequired(const uint32_t *regs);
+    uint8_t CPcurrentBits(float Current);
+    void ApplyVCOCache(uint32_t *regs);
+    void LearnVCO();
+    bool LearnVCOReadback(uint8_t Bucket);
+    uint8_t SelectOutputDivider(uint64_t Frequency, uint16_t FrequencyScale);
+    void PackFrequency(uint32_t *regs, uint32_t N_Int, uint32_t Mod, uint32_t Frac, uint8_t RfDivSel, bool FractionalMode);
+    int WriteCompactStep(uint32_t R0, uint16_t ModDivider);
+    void PackCompactStep(uint32_t R0, uint16_t ModDivider);
+    int PlanSweep(uint64_t StartFrequency, uint64_t StopFrequency, uint64_t StepFrequency, uint32_t *regs, MAX2870CompactStep *steps, uint16_t MaximumSteps, uint16_t *StepsPlanned);
+    int ValidateFrequency(uint32_t N_Int, uint32_t &Mod, uint32_t Frac, uint32_t PFDFreq);
+    int SweepBegin(SweepState &Sweep, uint64_t StartFrequency, uint64_t StepFrequency);
+    int SweepStep(SweepState &Sweep, uint32_t &N_Int, uint32_t &Mod, uint32_t &Frac, uint8_t &RfDivSel);
+    int FillSweepRing();
+    int StartSweep(uint64_t StartFrequency, uint64_t StopFrequency, uint64_t StepFrequency, bool LockGated, uint32_t SettleTime, uint32_t DwellTime, bool Repeat);
+    bool AdvancePlayback();
+    int StartPlayback(const uint32_t *regs, const MAX2870CompactStep *steps, uint16_t Steps, const uint16_t *DwellTicks, uint16_t DwellTime, uint32_t TickPeriod, bool Repeat);
+    int SetFrequency(uint64_t Frequency, uint16_t FrequencyScale, uint8_t PowerLevel, uint8_t AuxPowerLevel, uint8_t AuxFrequencyDivider, bool PrecisionFrequency, uint32_t MaximumFrequencyError, uint32_t CalculationTimeout);
+    bool CalculateFrequency(uint64_t Frequency, uint16_t FrequencyScale, bool PrecisionFrequency, uint32_t MaximumFrequencyError, uint32_t CalculationTimeout, uint32_t &N_Int, uint32_t &Mod, uint32_t &Frac, uint8_t &RfDivSel);
 
 };
 
+typedef MAX2870Device<> MAX2870; // on the hardware SPI
+
+#include "MAX2870Device.h"
+
 #endif
\ No newline at end of file
@@ -0,0 +1,224 @@
+/*!
+   @file MAX2870Constexpr.h
+
+   This is part of the Arduino Library for the MAX2870 PLL wideband frequency synthesier
+
+   Compile time (C++11 constexpr) calculation of the six registers for a fixed frequency with the same results as setrf()/setf() in channel step mode
+   from the power on defaults of the library - no frequency calculation is done at runtime when the plan is used in a constant expression
+
+*/
+
+#ifndef MAX2870CONSTEXPR_H
+#define MAX2870CONSTEXPR_H
+#include "MAX2870.h"
+
+// not constexpr - calling this from a constant expression stops compilation when the plan has an error
+inline uint32_t MAX2870_ConstPlanInvalid() {
+  return 0;
+}
+
+constexpr uint64_t MAX2870_ConstGCD(uint64_t a, uint64_t b) {
+  return (b == 0 ? a : MAX2870_ConstGCD(b, (a % b)));
+}
+
+constexpr uint64_t MAX2870_ConstMinimum(uint64_t a, uint64_t b) {
+  return (a < b ? a : b);
+}
+
+struct MAX2870ConstFraction {
+  uint32_t Frac;
+  uint32_t Mod;
+};
+
+// closest FRAC/MOD to Remainder / PFDnumerator with MOD <= 4095 and FRAC < MOD as per ClosestFraction() in MAX2870Device.h
+constexpr MAX2870ConstFraction MAX2870_ConstClosestBound(uint64_t Remainder, uint64_t PFDnumerator, uint64_t LowFrac, uint64_t LowMod, uint64_t HighFrac, uint64_t HighMod) {
+  return ((HighFrac != HighMod && (((HighFrac * PFDnumerator) - (Remainder * HighMod)) * LowMod) < (((Remainder * LowMod) - (LowFrac * PFDnumerator)) * HighMod)) ?
+          MAX2870ConstFraction{(uint32_t)HighFrac, (uint32_t)HighMod} : MAX2870ConstFraction{(uint32_t)LowFrac, (uint32_t)LowMod});
+}
+
+constexpr MAX2870ConstFraction MAX2870_ConstClosestFraction(uint64_t Remainder, uint64_t PFDnumerator, uint64_t LowFrac = 0, uint64_t LowMod = 1, uint64_t HighFrac = 1, uint64_t HighMod = 1) {
+  return (((Remainder * LowMod) == (LowFrac * PFDnumerator) || (LowMod + HighMod) > 4095) ? MAX2870_ConstClosestBound(Remainder, PFDnumerator, LowFrac, LowMod, HighFrac, HighMod) :
+          (((LowFrac + HighFrac) * PFDnumerator) == (Remainder * (LowMod + HighMod))) ? MAX2870ConstFraction{(uint32_t)(LowFrac + HighFrac), (uint32_t)(LowMod + HighMod)} :
+          (((LowFrac + HighFrac) * PFDnumerator) < (Remainder * (LowMod + HighMod))) ?
+          MAX2870_ConstClosestFraction(Remainder, PFDnumerator,
+                                       (LowFrac + (MAX2870_ConstMinimum((((Remainder * LowMod) - (LowFrac * PFDnumerator)) / ((HighFrac * PFDnumerator) - (Remainder * HighMod))), ((4095 - LowMod) / HighMod)) * HighFrac)),
+                                       (LowMod + (MAX2870_ConstMinimum((((Remainder * LowMod) - (LowFrac * PFDnumerator)) / ((HighFrac * PFDnumerator) - (Remainder * HighMod))), ((4095 - LowMod) / HighMod)) * HighMod)),
+                                       HighFrac, HighMod) :
+          MAX2870_ConstClosestFraction(Remainder, PFDnumerator, LowFrac, LowMod,
+                                       (HighFrac + (MAX2870_ConstMinimum((((HighFrac * PFDnumerator) - (Remainder * HighMod)) / ((Remainder * LowMod) - (LowFrac * PFDnumerator))), ((4095 - HighMod) / LowMod)) * LowFrac)),
+                                       (HighMod + (MAX2870_ConstMinimum((((HighFrac * PFDnumerator) - (Remainder * HighMod)) / ((Remainder * LowMod) - (LowFrac * PFDnumerator))), ((4095 - HighMod) / LowMod)) * LowMod))));
+}
+
+/*!
+   @brief registers for a fixed frequency calculated at compile time
+
+   constexpr MAX2870ConstPlan LO(10000000UL, 1, MAX2870_REF_UNDIVIDED, 100000UL, 4007500000ULL, 4, 0, MAX2870_AUX_DIVIDED);
+   static_assert(LO.Error() == MAX2870_ERROR_NONE, "LO frequency cannot be set");
+   constexpr uint32_t LORegisters[MAX2870_RegsToWrite] = MAX2870_CONST_REGISTERS(LO);
+
+   Error() returns the same error codes as setrf()/setf() - Register() stops compilation in a constant expression if there is an error
+*/
+struct MAX2870ConstPlan {
+  uint32_t ReferenceFrequency;
+  uint16_t ReferenceDivider;
+  uint8_t ReferenceDivisionType;
+  uint32_t ChannelStep;
+  uint64_t Frequency; // Hz
+  uint8_t PowerLevel;
+  uint8_t AuxPowerLevel;
+  uint8_t AuxFrequencyDivider;
+
+  constexpr MAX2870ConstPlan(uint32_t f, uint16_t r, uint8_t RefDivisionType, uint32_t StepFrequency, uint64_t FrequencyHz, uint8_t Power, uint8_t AuxPower, uint8_t AuxDivider)
+    : ReferenceFrequency(f), ReferenceDivider(r), ReferenceDivisionType(RefDivisionType), ChannelStep(StepFrequency), Frequency(FrequencyHz), PowerLevel(Power), AuxPowerLevel(AuxPower), AuxFrequencyDivider(AuxDivider) {}
+
+  // PFD = PFDnumerator / PFDdenominator
+  constexpr uint64_t PFDnumerator() const {
+    return ((uint64_t)ReferenceFrequency * (ReferenceDivisionType == MAX2870_REF_DOUBLE ? 2 : 1));
+  }
+  constexpr uint32_t PFDdenominator() const {
+    return ((uint32_t)ReferenceDivider * (ReferenceDivisionType == MAX2870_REF_HALF ? 2 : 1));
+  }
+  constexpr uint32_t PFDFrequency() const {
+    return (PFDnumerator() / PFDdenominator());
+  }
+
+  // as per SelectOutputDivider() in MAX2870Device.h
+  constexpr uint8_t DividerSelect(uint8_t Ratio, uint8_t OutputDivider = 1, uint8_t Select = 0) const {
+    return ((OutputDivider <= Ratio && OutputDivider <= 64) ? DividerSelect(Ratio, (OutputDivider * 2), (Select + 1)) : Select);
+  }
+  constexpr uint8_t RfDivSel() const {
+    return (Frequency > 23437500ULL ? DividerSelect((uint8_t)(3000000000ULL / Frequency)) : 7);
+  }
+  constexpr uint32_t OutputDivider() const {
+    return (1UL << RfDivSel());
+  }
+
+  // VCO = VCOnumerator / PFDdenominator
+  constexpr uint64_t VCOnumerator() const {
+    return (Frequency * OutputDivider() * PFDdenominator());
+  }
+  constexpr uint64_t Remainder() const {
+    return (VCOnumerator() % PFDnumerator());
+  }
+  constexpr uint64_t StepDenominator() const {
+    return ((uint64_t)ChannelStep * PFDdenominator());
+  }
+
+  // channel step FRAC/MOD before and after GCD reduction as per CalculateFrequency() in MAX2870Device.h
+  constexpr uint32_t ChannelMod() const {
+    return (PFDnumerator() / StepDenominator());
+  }
+  constexpr uint32_t ChannelFrac() const {
+    return (((Remainder() * OutputDivider() * 2) + StepDenominator()) / (StepDenominator() * OutputDivider() * 2));
+  }
+  constexpr uint32_t ReducedMod() const {
+    return (MAX2870_ConstGCD(ChannelMod(), ChannelFrac()) != 0 ? (ChannelMod() / MAX2870_ConstGCD(ChannelMod(), ChannelFrac())) : ChannelMod());
+  }
+  constexpr uint32_t ReducedFrac() const {
+    return (MAX2870_ConstGCD(ChannelMod(), ChannelFrac()) != 0 ? (ChannelFrac() / MAX2870_ConstGCD(ChannelMod(), ChannelFrac())) : ChannelFrac());
+  }
+
+  // closest FRAC/MOD (or the next INT) if MOD is greater than 4095 after GCD reduction
+  constexpr uint32_t ClampedFrac() const {
+    return (ReducedFrac() >= ReducedMod() ? (ReducedMod() - 1) : ReducedFrac());
+  }
+  constexpr MAX2870ConstFraction Closest() const {
+    return MAX2870_ConstClosestFraction(ClampedFrac(), ReducedMod());
+  }
+  constexpr uint64_t ClosestError() const {
+    return (((uint64_t)ClampedFrac() * Closest().Mod) > ((uint64_t)ReducedMod() * Closest().Frac) ?
+            (((uint64_t)ClampedFrac() * Closest().Mod) - ((uint64_t)ReducedMod() * Closest().Frac)) : (((uint64_t)ReducedMod() * Closest().Frac) - ((uint64_t)ClampedFrac() * Closest().Mod)));
+  }
+  constexpr bool NextInt() const {
+    return (ReducedMod() > 4095 && ((uint64_t)(ReducedMod() - ClampedFrac()) * Closest().Mod) < ClosestError());
+  }
+
+  // calculated values before MOD is corrected to 2 for integer-n mode
+  constexpr uint32_t N_Int() const {
+    return ((VCOnumerator() / PFDnumerator()) + (NextInt() == true ? 1 : 0));
+  }
+  constexpr uint32_t CalculatedFrac() const {
+    return (ReducedMod() <= 4095 ? ReducedFrac() : NextInt() == true ? 0 : Closest().Frac);
+  }
+  constexpr uint32_t CalculatedMod() const {
+    return (ReducedMod() <= 4095 ? ReducedMod() : NextInt() == true ? 2 : Closest().Mod);
+  }
+
+  // values written to the registers
+  constexpr uint32_t Frac() const {
+    return CalculatedFrac();
+  }
+  constexpr uint32_t Mod() const {
+    return (Frac() == 0 ? 2 : CalculatedMod());
+  }
+  constexpr bool FractionalMode() const {
+    return (Frac() != 0);
+  }
+
+  // frequency error at the RF output rounded to the nearest Hz as per ReadFrequencyError() after setf()
+  constexpr int64_t ErrorNumerator() const {
+    return (((int64_t)PFDnumerator() * CalculatedFrac()) - (((int64_t)Remainder() - ((int64_t)(NextInt() == true ? 1 : 0) * (int64_t)PFDnumerator())) * (int64_t)CalculatedMod()));
+  }
+  constexpr int64_t ErrorDivisor() const {
+    return ((int64_t)OutputDivider() * PFDdenominator() * CalculatedMod());
+  }
+  constexpr int32_t FrequencyError() const {
+    return (CalculatedMod() == 0 ? 0 : (ErrorNumerator() < 0 ? -(int32_t)((((-ErrorNumerator()) * 2) + ErrorDivisor()) / (ErrorDivisor() * 2)) : (int32_t)(((ErrorNumerator() * 2) + ErrorDivisor()) / (ErrorDivisor() * 2))));
+  }
+
+  // same checks and order as setrf(), setf() and ValidateFrequency() in MAX2870Device.h
+  constexpr int Error() const {
+    return ((ReferenceFrequency > 30000000UL && ReferenceDivisionType == MAX2870_REF_DOUBLE) ? MAX2870_ERROR_DOUBLER_EXCEEDED :
+            (ReferenceDivider > 1023 || ReferenceDivider < 1) ? MAX2870_ERROR_R_RANGE :
+            (ReferenceFrequency < MAX2870_REFIN_MIN || ReferenceFrequency > MAX2870_REFIN_MAX) ? MAX2870_ERROR_REF_FREQUENCY :
+            (ReferenceDivisionType != MAX2870_REF_UNDIVIDED && ReferenceDivisionType != MAX2870_REF_HALF && ReferenceDivisionType != MAX2870_REF_DOUBLE) ? MAX2870_ERROR_REF_MULTIPLIER_TYPE :
+            (PFDnumerator() > ((uint64_t)MAX2870_PFD_MAX * PFDdenominator()) || PFDnumerator() < ((uint64_t)MAX2870_PFD_MIN * PFDdenominator())) ? MAX2870_ERROR_PFD_LIMITS :
+            (PowerLevel > 4) ? MAX2870_ERROR_POWER_LEVEL :
+            (AuxPowerLevel > 4) ? MAX2870_ERROR_AUX_POWER_LEVEL :
+            (AuxFrequencyDivider != MAX2870_AUX_DIVIDED && AuxFrequencyDivider != MAX2870_AUX_FUNDAMENTAL) ? MAX2870_ERROR_AUX_FREQ_DIVIDER :
+            (ChannelStep == 0 || (ChannelStep > 1 && ((ReferenceFrequency / ReferenceDivider) % ChannelStep) != 0)) ? MAX2870_ERROR_PFD_AND_STEP_FREQUENCY_HAS_REMAINDER :
+            (Frequency > 6000000000ULL || Frequency < 23437500ULL) ? MAX2870_ERROR_RF_FREQUENCY :
+            (ChannelStep > 1 && (Frequency % ChannelStep) != 0) ? MAX2870_ERROR_RF_FREQUENCY_AND_STEP_FREQUENCY_HAS_REMAINDER :
+            (Mod() < 2 || Mod() > 4095) ? MAX2870_ERROR_MOD_RANGE :
+            (Frac() > (Mod() - 1)) ? MAX2870_ERROR_FRAC_RANGE :
+            (Frac() == 0 && (N_Int() < 16 || N_Int() > 65535)) ? MAX2870_ERROR_N_RANGE :
+            (Frac() != 0 && (N_Int() < 19 || N_Int() > 4091)) ? MAX2870_ERROR_N_RANGE_FRAC :
+            (Frac() != 0 && PFDFrequency() > MAX2870_PFD_MAX_FRAC) ? MAX2870_ERROR_PFD_EXCEEDED_WITH_FRACTIONAL_MODE :
+            MAX2870_ERROR_NONE);
+  }
+
+  // power on defaults as per MAX2870_R[] in MAX2870.h
+  constexpr uint32_t PowerOnDefault(uint8_t index) const {
+    return (index == 0 ? 0x007D0000UL : index == 1 ? 0x2000FFF9UL : index == 2 ? 0x18006E42UL : index == 3 ? 0x0000000BUL : index == 4 ? 0x6180B23CUL : 0x00400005UL);
+  }
+  constexpr uint32_t R0() const {
+    return MAX2870Field_INT::Set(MAX2870Field_N::Set(MAX2870Field_FRAC::Set(PowerOnDefault(0), Frac()), N_Int()), (FractionalMode() == true ? 0 : 1));
+  }
+  constexpr uint32_t R1() const {
+    return MAX2870Field_M::Set(MAX2870Field_CPOC::Set(MAX2870Field_CPL::Set(PowerOnDefault(1), (FractionalMode() == true ? 1 : 0)), (FractionalMode() == true ? 0 : 1)), Mod());
+  }
+  constexpr uint32_t R2() const {
+    return MAX2870Field_LDS::Set(MAX2870Field_LDF::Set(MAX2870Field_REFMODE::Set(MAX2870Field_R::Set(PowerOnDefault(2), ReferenceDivider), ReferenceDivisionType), (FractionalMode() == true ? 0 : 1)), (PFDFrequency() > 32000000UL ? 1 : 0));
+  }
+  constexpr uint32_t R4Power() const {
+    return (PowerLevel == 0 ? MAX2870Field_RFA_EN::Set(PowerOnDefault(4), 0) : MAX2870Field_APWR::Set(MAX2870Field_RFA_EN::Set(PowerOnDefault(4), 1), (PowerLevel - 1)));
+  }
+  constexpr uint32_t BandSelectDivider() const {
+    return MAX2870_ConstMinimum(((PFDnumerator() + ((uint64_t)PFDdenominator() * MAX2870_BAND_SELECT_CLOCK_MAX) - 1) / ((uint64_t)PFDdenominator() * MAX2870_BAND_SELECT_CLOCK_MAX)), 1023);
+  }
+  constexpr uint32_t R4() const {
+    return MAX2870Field_BS_MSB::Set(MAX2870Field_BS::Set(MAX2870Field_DIVA::Set((AuxPowerLevel == 0 ? MAX2870Field_RFB_EN::Set(R4Power(), 0) : MAX2870Field_BDIV::Set(MAX2870Field_RFB_EN::Set(MAX2870Field_BPWR::Set(R4Power(), (AuxPowerLevel - 1)), 1), AuxFrequencyDivider)), RfDivSel()), (BandSelectDivider() & 0xFF)), (BandSelectDivider() >> 8));
+  }
+  constexpr uint32_t R5() const {
+    return MAX2870Field_F01::Set(PowerOnDefault(5), (FractionalMode() == true ? 0 : 1));
+  }
+
+  constexpr uint32_t Register(uint8_t index) const {
+    return (Error() != MAX2870_ERROR_NONE ? MAX2870_ConstPlanInvalid() : index == 0 ? R0() : index == 1 ? R1() : index == 2 ? R2() : index == 3 ? PowerOnDefault(3) : index == 4 ? R4() : R5());
+  }
+};
+
+// initialiser for a uint32_t[MAX2870_RegsToWrite] for use with WriteSweepValues() (or WriteSweepValues_P() with PROGMEM)
+#define MAX2870_CONST_REGISTERS(plan) {(plan).Register(0), (plan).Register(1), (plan).Register(2), (plan).Register(3), (plan).Register(4), (plan).Register(5)}
+
+#endif
@@ -0,0 +1,2076 @@
+/*!
+
+   @file MAX2870Device.h
+
+   @mainpage MAX2870 Arduino library driver for Wideband Frequency Synthesizer
+
+   @section intro_sec Introduction
+
+   The MAX2870 chip is a wideband freqency synthesizer integrated circuit that can generate frequencies
+   from 23.475 MHz to 6 GHz. It incorporates a PLL (Fraction-N and Integer-N modes) and VCO, along with
+   prescalers, dividers and multipiers.  The users add a PLL loop filter and reference frequency to
+   create a frequency generator with a very wide range, that is tuneable in settable frequency steps.
+
+   The MAX2870 chip provides an SPI interface for setting the device registers that control the
+   frequency and output levels, along with several IO pins for gathering chip status and
+   enabling/disabling output and power modes.
+
+   The MAX2870 library provides an Arduino API for accessing the features of the ADF chip.
+
+   The basic PLL equations for the MAX2870 are:
+
+   \f$ RF_{out} = f_{PFD} \times (INT +(\frac{FRAC}{MOD})) \f$
+
+   where:
+
+   \f$ f_{PFD} = REF_{IN} \times \left[ \frac{(1 + D)}{( R \times (1 + T))} \right]  \f$
+
+   \f$ D = \textrm{RD2refdouble, ref doubler flag}\f$
+
+   \f$ R = \textrm{RCounter, ref divider}\f$
+
+   \f$ T = \textrm{RD1Rdiv2, ref divide by 2 flag}\f$
+
+
+
+
+   @section dependencies Dependencies
+
+   None other than the Arduino core and the SPI library
+
+   @section author Author
+
+   Bryce Cherry
+
+*/
+
+// MAX2870Device is a class template on its register transport, so its members are defined in this header which is included by MAX2870.h
+
+#ifndef MAX2870DEVICE_H
+#define MAX2870DEVICE_H
+#include "MAX2870.h"
+
+template <class Transport>
+MAX2870Device<Transport>::MAX2870Device()
+{
+  clearVCOCache();
+}
+
+template <class Transport>
+MAX2870Device<Transport>::MAX2870Device(const Transport &RegisterTransport) : MAX2870_Transport(RegisterTransport)
+{
+  clearVCOCache();
+}
+
+// fields in R1-R5 which only take effect (double buffered or VCO selection) when R0 is written afterwards
+static const uint32_t MAX2870_R0_LATCHED_FIELDS[6] = {
+  0x00000000, // R0
+  0x00007FF8, // R1 MOD
+  0x03FFC000, // R2 R counter, RDIV2 and reference doubler (double buffered with DBR)
+  0xFE000000, // R3 VCO/sub-band manual selection and VAS state machine
+  0x00700000, // R4 RF divider select (double buffered with DBR)
+  0x00000000  // R5
+};
+
+// taps of a maximal length Fibonacci LFSR of 2 to 16 bits (bit 0 is tap 1) for MAX2870_PLAYBACK_ORDER_RANDOM
+static const uint16_t MAX2870_LFSR_TAPS[15] PROGMEM = {
+  0x0003, 0x0006, 0x000C, 0x0014, 0x0030, 0x0060, 0x00B8, 0x0110,
+  0x0240, 0x0500, 0x0829, 0x100D, 0x2015, 0x6000, 0xD008
+};
+
+template <class Transport>
+int MAX2870Device<Transport>::WriteRegs()
+{
+  if (MAX2870_WriteMode == MAX2870_WRITE_MODE_QUEUE) {
+    return QueueRegs(false);
+  }
+  bool Retune = (MAX2870_VCOCacheMode == MAX2870_VCO_CACHE_LEARN && RetuneRequired(MAX2870_R)); // only a retune can be to a VCO frequency without a cached band
+  WriteRegisterSet(MAX2870_R);
+  if (Retune == true) {
+    LearnVCO();
+  }
+  return MAX2870_ERROR_NONE;
+}
+
+template <class Transport>
+int MAX2870Device<Transport>::WriteAllRegs()
+{
+  if (MAX2870_WriteMode == MAX2870_WRITE_MODE_QUEUE) {
+    return QueueRegs(true);
+  }
+  MAX2870_RegsWritten = false;
+  bool Retune = (MAX2870_VCOCacheMode == MAX2870_VCO_CACHE_LEARN && RetuneRequired(MAX2870_R)); // only a retune can be to a VCO frequency without a cached band
+  WriteRegisterSet(MAX2870_R);
+  if (Retune == true) {
+    LearnVCO();
+  }
+  return MAX2870_ERROR_NONE;
+}
+
+template <class Transport>
+void MAX2870Device<Transport>::WriteRegisterSet(const uint32_t *regs)
+{
+  // only registers which differ from MAX2870_R_Written are written
+  uint8_t Sequence[MAX2870_RegsToWrite];
+  uint8_t SequenceLength = 0;
+  bool R0required = RetuneRequired(regs);
+  uint32_t BoostedRegs[MAX2870_RegsToWrite];
+  bool Boosted = false;
+  if (R0required == true && MAX2870_FastLockMode == MAX2870_FAST_LOCK_SOFTWARE) { // R2 with the boost charge pump current is written before R0
+    for (int i = 0; i < (int)MAX2870_RegsToWrite; i++) {
+      BoostedRegs[i] = regs[i];
+    }
+    MAX2870_FastLockRestoreCP = MAX2870Field_CP::Read(regs);
+    MAX2870Field_CP::Write(BoostedRegs, MAX2870_FastLockBoostCP);
+    regs = BoostedRegs;
+    Boosted = true;
+  }
+  for (int i = 5 ; i >= 1 ; i--) { // sequence according to the MAX2870 datasheet
+    if (MAX2870_RegsWritten == false || regs[i] != MAX2870_R_Written[i]) {
+      Sequence[SequenceLength++] = i;
+    }
+  }
+  if (R0required == true) { // always last
+    Sequence[SequenceLength++] = 0;
+  }
+  uint8_t Buffer[MAX2870_RegsToWrite * 4];
+  for (int i = 0; i < SequenceLength; i++) {
+    uint32_t value = regs[Sequence[i]];
+    Buffer[(i * 4)] = value >> 24; // MSB first
+    Buffer[(i * 4) + 1] = value >> 16;
+    Buffer[(i * 4) + 2] = value >> 8;
+    Buffer[(i * 4) + 3] = value;
+  }
+  if (MAX2870_WriteMode == MAX2870_WRITE_MODE_REGISTER) { // one transaction for each register
+    for (int i = 0; i < SequenceLength; i++) {
+      MAX2870_Transport.write(&Buffer[(i * 4)], 1);
+    }
+  }
+  else if (SequenceLength > 0) { // queued register sets are also written in one transaction
+    MAX2870_Transport.write(Buffer, SequenceLength);
+  }
+  for (int i = 0; i < SequenceLength; i++) {
+    MAX2870_R_Written[Sequence[i]] = regs[Sequence[i]];
+  }
+  MAX2870_RegsWrittenCount = SequenceLength;
+  MAX2870_RegsWritten = true;
+  for (int i = 0; i < SequenceLength; i++) {
+    if (Sequence[i] == 2 && Boosted == false) { // the charge pump current has been written as is
+      MAX2870_FastLockPending = false;
+    }
+  }
+  if (R0required == true && MAX2870_LockPinUsed == true) { // the PLL relocks from the R0 write
+    MAX2870_LockStartTime = micros();
+    MAX2870_LockBand = MAX2870Field_DIVA::Get(regs[4]);
+    MAX2870_LockPending = true;
+  }
+  if (Boosted == true) {
+    MAX2870_FastLockStartTime = micros();
+    MAX2870_FastLockPending = true;
+  }
+}
+
+template <class Transport>
+bool MAX2870Device<Transport>::RetuneRequired(const uint32_t *regs)
+{
+  // R0 is written when it has changed or when a field which is latched by R0 has changed
+  if (MAX2870_RegsWritten == false || regs[0] != MAX2870_R_Written[0]) {
+    return true;
+  }
+  for (int i = 1; i < (int)MAX2870_RegsToWrite; i++) {
+    if (((regs[i] ^ MAX2870_R_Written[i]) & MAX2870_R0_LATCHED_FIELDS[i]) != 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+template <class Transport>
+int MAX2870Device<Transport>::QueueRegs(bool AllRegisters)
+{
+  // single producer - the slot is filled before the tail is advanced so that serviceQueue() never sees a partly queued register set
+  uint8_t Tail = MAX2870_QueueTail;
+  uint8_t NextTail = ((Tail + 1) % (MAX2870_QUEUE_SIZE + 1));
+  if (NextTail == MAX2870_QueueHead) { // queue is full - the changes stay in MAX2870_R[] for the next WriteRegs()
+    return MAX2870_ERROR_QUEUE_FULL;
+  }
+  for (int i = 0; i < (int)MAX2870_RegsToWrite; i++) {
+    MAX2870_Queue[Tail].Registers[i] = MAX2870_R[i];
+  }
+  MAX2870_QueueSequence++;
+  MAX2870_Queue[Tail].Sequence = MAX2870_QueueSequence;
+  MAX2870_Queue[Tail].AllRegisters = AllRegisters;
+  MAX2870_QueueTail = NextTail;
+  return MAX2870_ERROR_NONE;
+}
+
+template <class Transport>
+void MAX2870Device<Transport>::serviceQueue()
+{
+  // single consumer - writes the oldest queued register set and then calls the completion callback
+  serviceFastLock();
+  uint8_t Head = MAX2870_QueueHead;
+  if (Head == MAX2870_QueueTail) {
+    return;
+  }
+  uint32_t Registers[MAX2870_RegsToWrite];
+  for (int i = 0; i < (int)MAX2870_RegsToWrite; i++) {
+    Registers[i] = MAX2870_Queue[Head].Registers[i];
+  }
+  uint16_t Sequence = MAX2870_Queue[Head].Sequence;
+  if (MAX2870_Queue[Head].AllRegisters == true) {
+    MAX2870_RegsWritten = false;
+  }
+  MAX2870_QueueHead = ((Head + 1) % (MAX2870_QUEUE_SIZE + 1)); // the slot has been copied and can be reused
+  WriteRegisterSet(Registers);
+  if (MAX2870_QueueCallback != NULL) {
+    MAX2870_QueueCallback(Sequence);
+  }
+}
+
+template <class Transport>
+uint8_t MAX2870Device<Transport>::queuedWrites()
+{
+  uint8_t Head = MAX2870_QueueHead;
+  uint8_t Tail = MAX2870_QueueTail;
+  if (Tail >= Head) {
+    return (Tail - Head);
+  }
+  return ((Tail + MAX2870_QUEUE_SIZE + 1) - Head);
+}
+
+template <class Transport>
+void MAX2870Device<Transport>::setQueueCallback(MAX2870QueueCallback Callback)
+{
+  MAX2870_QueueCallback = Callback;
+}
+
+template <class Transport>
+uint8_t MAX2870Device<Transport>::serviceLock()
+{
+  // interrupts are disabled as a register write from an interrupt may start a new measurement at any time
+  if (MAX2870_LockPending == false) {
+    return MAX2870_LOCK_STATUS_IDLE;
+  }
+  uint8_t Status = MAX2870_LOCK_STATUS_IDLE;
+  noInterrupts();
+  if (MAX2870_LockPending == true) {
+    Status = RecordLock(micros(), (digitalRead(MAX2870_PIN_LD) == HIGH));
+  }
+  interrupts();
+  return Status;
+}
+
+template <class Transport>
+void MAX2870Device<Transport>::lockInterrupt()
+{
+  if (MAX2870_LockPending == true) {
+    RecordLock(micros(), true);
+  }
+}
+
+template <class Transport>
+uint8_t MAX2870Device<Transport>::RecordLock(uint32_t CurrentTime, bool Locked)
+{
+  uint32_t LockTime = CurrentTime - MAX2870_LockStartTime;
+  LockBandState *Band = &MAX2870_LockBands[MAX2870_LockBand];
+  if (Locked == true) {
+    MAX2870_LockTime = LockTime;
+    if (Band->Locks == 0 || LockTime < Band->Minimum) {
+      Band->Minimum = LockTime;
+    }
+    if (LockTime > Band->Maximum) {
+      Band->Maximum = LockTime;
+    }
+    Band->Total += LockTime;
+    Band->Locks++;
+    uint8_t Bin = 0;
+    while (Bin < (MAX2870_LOCK_HISTOGRAM_BINS - 1) && LockTime >= (MAX2870_LOCK_HISTOGRAM_FIRST_BIN << Bin)) {
+      Bin++;
+    }
+    if (Band->Histogram[Bin] != 0xFFFF) {
+      Band->Histogram[Bin]++;
+    }
+    MAX2870_LockPending = false;
+    return MAX2870_LOCK_STATUS_LOCKED;
+  }
+  if (LockTime > MAX2870_LOCK_TIMEOUT) {
+    Band->Timeouts++;
+    MAX2870_LockPending = false;
+    return MAX2870_LOCK_STATUS_TIMEOUT;
+  }
+  return MAX2870_LOCK_STATUS_WAITING;
+}
+
+template <class Transport>
+int MAX2870Device<Transport>::waitForLock(uint32_t Timeout)
+{
+  // the lock time of a retune which is being measured is recorded as per serviceLock()
+  if (MAX2870_LockPinUsed == false) {
+    return MAX2870_ERROR_LOCK_PIN_UNUSED;
+  }
+  uint32_t StartTime = micros();
+  while (true) {
+    serviceFastLock();
+    uint8_t LockStatus = serviceLock();
+    if (LockStatus == MAX2870_LOCK_STATUS_LOCKED || (LockStatus == MAX2870_LOCK_STATUS_IDLE && digitalRead(MAX2870_PIN_LD) == HIGH)) {
+      return MAX2870_ERROR_NONE;
+    }
+    if ((micros() - StartTime) >= Timeout) {
+      return MAX2870_ERROR_LOCK_TIMEOUT;
+    }
+  }
+}
+
+template <class Transport>
+int MAX2870Device<Transport>::ReadLockStatistics(uint8_t Band, MAX2870LockStatistics *Statistics)
+{
+  if (Band >= MAX2870_LOCK_BANDS) {
+    return MAX2870_ERROR_LOCK_BAND;
+  }
+  noInterrupts();
+  const LockBandState *State = &MAX2870_LockBands[Band];
+  Statistics->Locks = State->Locks;
+  Statistics->Timeouts = State->Timeouts;
+  Statistics->Minimum = State->Minimum;
+  Statistics->Maximum = State->Maximum;
+  if (State->Locks != 0) {
+    Statistics->Mean = (State->Total / State->Locks);
+  }
+  else {
+    Statistics->Mean = 0;
+  }
+  for (int i = 0; i < MAX2870_LOCK_HISTOGRAM_BINS; i++) {
+    Statistics->Histogram[i] = State->Histogram[i];
+  }
+  interrupts();
+  return MAX2870_ERROR_NONE;
+}
+
+template <class Transport>
+void MAX2870Device<Transport>::clearLockStatistics()
+{
+  noInterrupts();
+  for (int i = 0; i < MAX2870_LOCK_BANDS; i++) {
+    MAX2870_LockBands[i].Locks = 0;
+    MAX2870_LockBands[i].Timeouts = 0;
+    MAX2870_LockBands[i].Minimum = 0;
+    MAX2870_LockBands[i].Maximum = 0;
+    MAX2870_LockBands[i].Total = 0;
+    for (int j = 0; j < MAX2870_LOCK_HISTOGRAM_BINS; j++) {
+      MAX2870_LockBands[i].Histogram[j] = 0;
+    }
+  }
+  interrupts();
+}
+
+template <class Transport>
+int MAX2870Device<Transport>::setVCOCache(uint8_t Mode)
+{
+  if (Mode == MAX2870_VCO_CACHE_LEARN && MAX2870_PlaybackRunning == true) return MAX2870_ERROR_PLAYBACK_WRITE_MODE;
+  if (Mode == MAX2870_VCO_CACHE_LEARN && MAX2870_WriteMode == MAX2870_WRITE_MODE_QUEUE) return MAX2870_ERROR_VCO_CACHE_WRITE_MODE; // queued writes are not followed by learning and there is no readback
+  if (Mode == MAX2870_VCO_CACHE_ON && MAX2870_PlaybackRunning == true && MAX2870_PlaybackSteps != NULL) return MAX2870_ERROR_PLAYBACK_WRITE_MODE; // tick() would divide in 64 bits for the VCO bucket of each compact step
+  if (Mode == MAX2870_VCO_CACHE_OFF) { // return the VCO band selection to the VAS state machine from the next retune
+    MAX2870_WriteFields<MAX2870Field_VCO, MAX2870Field_VAS_SHDN>(MAX2870_R, 0, 0);
+  }
+  else if (Mode != MAX2870_VCO_CACHE_ON && Mode != MAX2870_VCO_CACHE_LEARN) {
+    return MAX2870_ERROR_VCO_CACHE_MODE;
+  }
+  MAX2870_VCOCacheMode = Mode;
+  return MAX2870_ERROR_NONE;
+}
+
+template <class Transport>
+void MAX2870Device<Transport>::exportVCOCache(uint8_t *Cache)
+{
+  for (int i = 0; i < MAX2870_VCO_CACHE_SIZE; i++) {
+    Cache[i] = MAX2870_VCOCache[i];
+  }
+}
+
+template <class Transport>
+void MAX2870Device<Transport>::importVCOCache(const uint8_t *Cache)
+{
+  for (int i = 0; i < MAX2870_VCO_CACHE_SIZE; i++) {
+    if (Cache[i] < MAX2870_VCO_BANDS) {
+      MAX2870_VCOCache[i] = Cache[i];
+    }
+    else {
+      MAX2870_VCOCache[i] = MAX2870_VCO_UNKNOWN;
+    }
+  }
+}
+
+template <class Transport>
+void MAX2870Device<Transport>::clearVCOCache()
+{
+  for (int i = 0; i < MAX2870_VCO_CACHE_SIZE; i++) {
+    MAX2870_VCOCache[i] = MAX2870_VCO_UNKNOWN;
+  }
+}
+
+template <class Transport>
+uint8_t MAX2870Device<Transport>::VCOBucket(const uint32_t *regs)
+{
+  // exact as VCO = reference * (1 + DBR) * (N * MOD + FRAC) / (R * (1 + RDIV2) * MOD) so that a VCO frequency just above a bucket edge is not put in the bucket below
+  uint32_t R = MAX2870Field_R::Read(regs);
+  if (R == 0) {
+    return 0;
+  }
+  uint64_t Mod = 1;
+  uint64_t Frac = 0;
+  if (MAX2870Field_INT::Read(regs) == 0 && MAX2870Field_M::Read(regs) != 0) {
+    Mod = MAX2870Field_M::Read(regs);
+    Frac = MAX2870Field_FRAC::Read(regs);
+  }
+  uint64_t VCONumerator = (((uint64_t)MAX2870_reffreq << MAX2870Field_DBR::Read(regs)) * ((MAX2870Field_N::Read(regs) * Mod) + Frac));
+  uint64_t VCODenominator = ((uint64_t)(R << MAX2870Field_RDIV2::Read(regs)) * Mod);
+  uint64_t BucketStart = (3000000000ULL * VCODenominator);
+  if (VCONumerator <= BucketStart) {
+    return 0;
+  }
+  uint64_t Bucket = ((VCONumerator - BucketStart) / ((MAX2870_VCO_BUCKET_WIDTH * 1000ULL) * VCODenominator));
+  if (Bucket >= MAX2870_VCO_CACHE_SIZE) {
+    Bucket = (MAX2870_VCO_CACHE_SIZE - 1);
+  }
+  return Bucket;
+}
+
+template <class Transport>
+void MAX2870Device<Transport>::SetBandSelectDivider(uint32_t *regs)
+{
+  // smallest divider for a band select clock (PFD / BS) of no more than MAX2870_BAND_SELECT_CLOCK_MAX - exact as PFD = reference * (1 + DBR) / (R * (1 + RDIV2))
+  uint32_t PFDnumerator = (MAX2870_reffreq << MAX2870Field_DBR::Read(regs));
+  uint32_t BandSelectDenominator = ((MAX2870Field_R::Read(regs) << MAX2870Field_RDIV2::Read(regs)) * MAX2870_BAND_SELECT_CLOCK_MAX);
+  uint32_t BandSelectDivider = 1;
+  if (BandSelectDenominator != 0) {
+    BandSelectDivider = ((PFDnumerator + BandSelectDenominator - 1) / BandSelectDenominator);
+  }
+  if (BandSelectDivider < 1) {
+    BandSelectDivider = 1;
+  }
+  if (BandSelectDivider > 1023) { // only with an integer-N PFD above 1023 * MAX2870_BAND_SELECT_CLOCK_MAX
+    BandSelectDivider = 1023;
+    MAX2870_Warnings |= MAX2870_WARNING_FLAG_BAND_SELECT_CLAMPED;
+  }
+  MAX2870_WriteFields<MAX2870Field_BS, MAX2870Field_BS_MSB>(regs, (BandSelectDivider & 0xFF), (BandSelectDivider >> 8));
+}
+
+template <class Transport>
+void MAX2870Device<Transport>::SetFastLockDivider(uint32_t *regs)
+{
+  // the fast lock lasts MOD * CDIV / PFD, so CDIV = timeout * PFD / MOD rounded up so that it lasts for no less than the timeout - exact as per SetBandSelectDivider()
+  // called by PackFrequency() as MOD changes with the frequency
+  if (MAX2870_FastLockMode != MAX2870_FAST_LOCK_HARDWARE) {
+    MAX2870_WriteFields<MAX2870Field_CDIV, MAX2870Field_CDM>(regs, 1, 0); // clock divider off
+    return;
+  }
+  uint32_t Mod = MAX2870Field_M::Read(regs);
+  if (Mod == 0) {
+    Mod = 1;
+  }
+  uint64_t TimeoutNumerator = ((uint64_t)MAX2870_FastLockTimeout * (MAX2870_reffreq << MAX2870Field_DBR::Read(regs)));
+  uint64_t TimeoutDenominator = ((uint64_t)(MAX2870Field_R::Read(regs) << MAX2870Field_RDIV2::Read(regs)) * Mod * 1000000UL);
+  uint32_t ClockDivider = MAX2870_FAST_LOCK_DIVIDER_MAX;
+  if (TimeoutDenominator != 0) {
+    uint64_t Divider = ((TimeoutNumerator + TimeoutDenominator - 1) / TimeoutDenominator);
+    if (Divider < MAX2870_FAST_LOCK_DIVIDER_MAX) {
+      ClockDivider = Divider;
+    }
+  }
+  if (ClockDivider < 1) {
+    ClockDivider = 1;
+  }
+  MAX2870_WriteFields<MAX2870Field_CDIV, MAX2870Field_CDM>(regs, ClockDivider, 1); // fast lock
+}
+
+template <class Transport>
+void MAX2870Device<Transport>::ApplyVCOCache(uint32_t *regs)
+{
+  uint8_t Band = MAX2870_VCOCache[VCOBucket(regs)];
+  if (Band < MAX2870_VCO_BANDS) { // MAX2870_VCO_UNKNOWN and MAX2870_VCO_NOT_FOUND use the VAS state machine
+    MAX2870_WriteFields<MAX2870Field_VCO, MAX2870Field_VAS_SHDN>(regs, Band, 1); // VAS state machine disabled
+  }
+  else {
+    MAX2870_WriteFields<MAX2870Field_VCO, MAX2870Field_VAS_SHDN>(regs, 0, 0);
+  }
+}
+
+template <class Transport>
+void MAX2870Device<Transport>::LearnVCO()
+{
+  // called after a retune under MAX2870_VCO_CACHE_LEARN - only the readback is used so that a write waits no more than MAX2870_VCO_LEARN_TIMEOUT
+  // without readback the VAS state machine is left to select the band and MAX2870_WARNING_FLAG_VCO_NOT_LEARNED is latched (learnVCOBand() searches with the lock pin)
+  if (MAX2870Field_VAS_SHDN::Read(MAX2870_R) == 1) { // the VCO frequency already has a cached band
+    return;
+  }
+  uint8_t Bucket = VCOBucket(MAX2870_R);
+  if (MAX2870_VCOCache[Bucket] == MAX2870_VCO_NOT_FOUND) {
+    return;
+  }
+  if (LearnVCOReadback(Bucket) == false) {
+    MAX2870_Warnings |= MAX2870_WARNING_FLAG_VCO_NOT_LEARNED;
+  }
+}
+
+template <class Transport>
+bool MAX2870Device<Transport>::LearnVCOReadback(uint8_t Bucket)
+{
+  // caches the VCO band chosen by the VAS state machine once it has finished, or MAX2870_VCO_NOT_FOUND if it has not within MAX2870_VCO_LEARN_TIMEOUT - returns false without readback
+  MAX2870Status Status;
+  if (readStatusRegister(&Status) != MAX2870_ERROR_NONE) {
+    return false;
+  }
+  uint32_t StartTime = micros();
+  while (Status.VASActive == true && (micros() - StartTime) < MAX2870_VCO_LEARN_TIMEOUT) {
+    readStatusRegister(&Status);
+  }
+  if (Status.VASActive == false) {
+    MAX2870_VCOCache[Bucket] = Status.VCO;
+    ApplyVCOCache(MAX2870_R);
+    WriteRegisterSet(MAX2870_R);
+  }
+  else {
+    MAX2870_VCOCache[Bucket] = MAX2870_VCO_NOT_FOUND;
+  }
+  MAX2870_LockPending = false; // learning is not a retune for the lock time statistics
+  return true;
+}
+
+template <class Transport>
+int MAX2870Device<Transport>::learnVCOBand()
+{
+  // relearns the VCO band of the current VCO frequency from the readback or, without readback, tries each VCO band with the VAS state machine disabled and caches the middle of the first run of bands which lock
+  // the lock pin search waits up to MAX2870_VCO_LEARN_TIMEOUT for each band so it is only done when called - e.g. from setup() for each frequency of a hop table
+  if (MAX2870_VCOCacheMode == MAX2870_VCO_CACHE_OFF) return MAX2870_ERROR_VCO_CACHE_MODE;
+  if (MAX2870_WriteMode == MAX2870_WRITE_MODE_QUEUE) return MAX2870_ERROR_VCO_CACHE_WRITE_MODE;
+  if (MAX2870_PlaybackRunning == true) return MAX2870_ERROR_PLAYBACK_WRITE_MODE;
+  uint8_t Bucket = VCOBucket(MAX2870_R);
+  MAX2870_VCOCache[Bucket] = MAX2870_VCO_UNKNOWN;
+  ApplyVCOCache(MAX2870_R); // the VAS state machine selects the band
+  MAX2870_RegsWritten = false; // all registers with R0 last so that the VAS state machine runs
+  WriteRegisterSet(MAX2870_R);
+  if (LearnVCOReadback(Bucket) == false) {
+    if (MAX2870_LockPinUsed == false) {
+      return MAX2870_ERROR_LOCK_PIN_UNUSED;
+    }
+    uint8_t FirstBand = MAX2870_VCO_UNKNOWN;
+    uint8_t LastBand = MAX2870_VCO_UNKNOWN;
+    for (int Band = 0; Band < MAX2870_VCO_BANDS; Band++) {
+      MAX2870_WriteFields<MAX2870Field_VCO, MAX2870Field_VAS_SHDN>(MAX2870_R, Band, 1);
+      WriteRegisterSet(MAX2870_R);
+      delayMicroseconds(MAX2870_VCO_LEARN_DELAY);
+      bool Locked = false;
+      uint32_t StartTime = micros();
+      while ((micros() - StartTime) < MAX2870_VCO_LEARN_TIMEOUT) {
+        if (digitalRead(MAX2870_PIN_LD) == HIGH) {
+          Locked = true;
+          break;
+        }
+      }
+      if (Locked == true) {
+        if (FirstBand == MAX2870_VCO_UNKNOWN) {
+          FirstBand = Band;
+        }
+        LastBand = Band;
+      }
+      else if (FirstBand != MAX2870_VCO_UNKNOWN) {
+        break;
+      }
+    }
+    if (FirstBand != MAX2870_VCO_UNKNOWN) {
+      MAX2870_VCOCache[Bucket] = ((FirstBand + LastBand) / 2);
+    }
+    else {
+      MAX2870_VCOCache[Bucket] = MAX2870_VCO_NOT_FOUND;
+    }
+    ApplyVCOCache(MAX2870_R); // the VAS state machine is used again if no band has locked
+    WriteRegisterSet(MAX2870_R);
+    MAX2870_LockPending = false; // the band search is not a retune for the lock time statistics
+  }
+  if (MAX2870_VCOCache[Bucket] == MAX2870_VCO_NOT_FOUND) {
+    return MAX2870_ERROR_VCO_NOT_FOUND;
+  }
+  return MAX2870_ERROR_NONE;
+}
+
+template <class Transport>
+uint8_t MAX2870Device<Transport>::readWarnings()
+{
+  uint8_t Warnings = MAX2870_Warnings;
+  MAX2870_Warnings = 0;
+  return Warnings;
+}
+
+template <class Transport>
+int MAX2870Device<Transport>::readStatusRegister(MAX2870Status *Status)
+{
+  // MUXOUT is set to register readback (MUX = 1100) for the read and then returned to its previous function
+  // only MUX is changed from the registers as latched so that a boosted charge pump current of MAX2870_FAST_LOCK_SOFTWARE stays until serviceFastLock() restores it
+  if (MAX2870_WriteMode == MAX2870_WRITE_MODE_QUEUE) {
+    return MAX2870_ERROR_READBACK;
+  }
+  uint32_t Latched[MAX2870_RegsToWrite];
+  uint32_t Readback[MAX2870_RegsToWrite];
+  for (int i = 0; i < (int)MAX2870_RegsToWrite; i++) {
+    Latched[i] = ((MAX2870_RegsWritten == true) ? MAX2870_R_Written[i] : MAX2870_R[i]);
+    Readback[i] = Latched[i];
+  }
+  MAX2870Field_MUX::Write(Readback, 0x04);
+  MAX2870Field_MUX_MSB::Write(Readback, 1);
+  bool FastLockPending = MAX2870_FastLockPending; // R2 is written as is by the readback
+  WriteRegisterSet(Readback);
+  uint32_t Value;
+  bool ValueRead = MAX2870_Transport.read(&Value);
+  WriteRegisterSet(Latched);
+  MAX2870_FastLockPending = FastLockPending;
+  if (ValueRead == false || (Value & 0x07) != 0x06) { // R6 has the register address in bits 0-2 which an unconnected MUXOUT does not
+    return MAX2870_ERROR_READBACK;
+  }
+  Status->Register = Value;
+  Status->Die = MAX2870Field_DIE::Get(Value);
+  Status->PowerOnReset = (MAX2870Field_POR::Get(Value) == 1);
+  Status->ADC = MAX2870Field_ADC::Get(Value);
+  Status->ADCValid = (MAX2870Field_ADCV::Get(Value) == 1);
+  Status->VASActive = (MAX2870Field_VASA::Get(Value) == 1);
+  Status->VCO = MAX2870Field_V::Get(Value);
+  return MAX2870_ERROR_NONE;
+}
+
+template <class Transport>
+int MAX2870Device<Transport>::setADCMode(uint8_t Mode)
+{
+  if (Mode != MAX2870_ADC_OFF && Mode != MAX2870_ADC_TEMPERATURE && Mode != MAX2870_ADC_TUNE_VOLTAGE) {
+    return MAX2870_ERROR_ADC_MODE;
+  }
+  MAX2870_WriteFields<MAX2870Field_ADCM, MAX2870Field_ADCS>(MAX2870_R, Mode, (Mode != MAX2870_ADC_OFF));
+  return WriteRegs();
+}
+
+template <class Transport>
+int MAX2870Device<Transport>::WriteSweepValues(const uint32_t *regs) {
+  for (int i = 0; i < (int)MAX2870_RegsToWrite; i++) {
+    MAX2870_R[i] = regs[i];
+  }
+  return WriteRegs();
+}
+
+template <class Transport>
+void MAX2870Device<Transport>::ReadSweepValues(uint32_t *regs) {
+  for (int i = 0; i < (int)MAX2870_RegsToWrite; i++) {
+    regs[i] = MAX2870_R[i];
+  }
+}
+
+template <class Transport>
+int MAX2870Device<Transport>::WriteCompactSweepValues(const MAX2870CompactStep *step) {
+  return WriteCompactStep(step->R0, step->ModDivider);
+}
+
+template <class Transport>
+int MAX2870Device<Transport>::WriteCompactStep(uint32_t R0, uint16_t ModDivider) {
+  PackCompactStep(R0, ModDivider);
+  return WriteRegs();
+}
+
+template <class Transport>
+void MAX2870Device<Transport>::PackCompactStep(uint32_t R0, uint16_t ModDivider) {
+  // R1/R2/R4/R5 are derived from the current registers so that only R0 is written within the same RF divider band and MOD
+  uint32_t N_Int = MAX2870Field_N::Get(R0);
+  uint32_t Frac = MAX2870Field_FRAC::Get(R0);
+  bool FractionalMode = (MAX2870Field_INT::Get(R0) == 0);
+  PackFrequency(MAX2870_R, N_Int, (ModDivider & 0x0FFF), Frac, ((ModDivider >> 12) & 0x07), FractionalMode);
+}
+
+template <class Transport>
+void MAX2870Device<Transport>::ReadCompactSweepValues(MAX2870CompactStep *step) {
+  step->R0 = MAX2870_R[0x00];
+  step->ModDivider = (ReadMod() | ((uint16_t)ReadOutDivider_PowerOf2() << 12));
+}
+
+template <class Transport>
+int MAX2870Device<Transport>::WriteSweepValues_P(const uint32_t *regs) {
+  for (int i = 0; i < (int)MAX2870_RegsToWrite; i++) {
+    MAX2870_R[i] = MAX2870_ReadFlashDword(&regs[i]);
+  }
+  return WriteRegs();
+}
+
+template <class Transport>
+int MAX2870Device<Transport>::WriteCompactSweepValues_P(const MAX2870CompactStep *step) {
+  return WriteCompactStep(MAX2870_ReadFlashDword(&step->R0), MAX2870_ReadFlashWord(&step->ModDivider));
+}
+
+template <class Transport>
+uint16_t MAX2870Device<Transport>::ReadR() {
+  return MAX2870Field_R::Read(MAX2870_R);
+}
+
+template <class Transport>
+uint16_t MAX2870Device<Transport>::ReadInt() {
+  return MAX2870Field_N::Read(MAX2870_R);
+}
+
+template <class Transport>
+uint16_t MAX2870Device<Transport>::ReadFraction() {
+  return MAX2870Field_FRAC::Read(MAX2870_R);
+}
+
+template <class Transport>
+uint16_t MAX2870Device<Transport>::ReadMod() {
+  return MAX2870Field_M::Read(MAX2870_R);
+}
+
+template <class Transport>
+uint8_t MAX2870Device<Transport>::ReadOutDivider() {
+  return (1 << MAX2870Field_DIVA::Read(MAX2870_R));
+}
+
+template <class Transport>
+uint8_t MAX2870Device<Transport>::ReadOutDivider_PowerOf2() {
+  return MAX2870Field_DIVA::Read(MAX2870_R);
+}
+
+template <class Transport>
+uint8_t MAX2870Device<Transport>::ReadRDIV2() {
+  return MAX2870Field_RDIV2::Read(MAX2870_R);
+}
+
+template <class Transport>
+uint8_t MAX2870Device<Transport>::ReadRefDoubler() {
+  return MAX2870Field_DBR::Read(MAX2870_R);
+}
+
+template <class Transport>
+double MAX2870Device<Transport>::ReadPFDfreq() {
+  double value = MAX2870_reffreq;
+  uint16_t temp = ReadR();
+  if (temp == 0) { // avoid division by zero
+    return 0;
+  }
+  value /= temp;
+  if (ReadRDIV2() != 0) {
+    value /= 2;
+  }
+  if (ReadRefDoubler() != 0) {
+    value *= 2;
+  }
+  return value;
+}
+
+template <class Transport>
+int32_t MAX2870Device<Transport>::ReadFrequencyError() {
+  return MAX2870_FrequencyError;
+}
+
+template <class Transport>
+void MAX2870Device<Transport>::ReadCurrentFrequency(char *freq)
+{
+  // exact rational calculation: RF = REFIN * (1 + D) / (R * (1 + T)) * (INT + FRAC / MOD) / RF divider
+  uint64_t FrequencyNumerator = MAX2870_reffreq;
+  uint64_t FrequencyDenominator = ReadR();
+  if (ReadRDIV2() != 0 && ReadRefDoubler() == 0) {
+    FrequencyDenominator *= 2;
+  }
+  else if (ReadRDIV2() == 0 && ReadRefDoubler() != 0) {
+    FrequencyNumerator *= 2;
+  }
+  FrequencyNumerator *= (((uint64_t)ReadInt() * ReadMod()) + ReadFraction());
+  FrequencyDenominator *= ReadMod();
+  FrequencyDenominator *= ReadOutDivider();
+  uint32_t DecimalScale = 1;
+  for (int i = 0; i < MAX2870_DECIMAL_PLACES; i++) {
+    DecimalScale *= 10;
+  }
+  uint64_t IntegerPart = FrequencyNumerator / FrequencyDenominator;
+  uint64_t DecimalPart = (((FrequencyNumerator % FrequencyDenominator) * DecimalScale * 2) + FrequencyDenominator) / (FrequencyDenominator * 2); // rounded to the nearest decimal place
+  if (DecimalPart >= DecimalScale) {
+    DecimalPart -= DecimalScale;
+    IntegerPart++;
+  }
+  char Digits[MAX2870_DIGITS];
+  uint8_t DigitCount = 0;
+  do {
+    Digits[DigitCount] = '0' + (IntegerPart % 10);
+    DigitCount++;
+    IntegerPart /= 10;
+  } while (IntegerPart != 0 && DigitCount < MAX2870_DIGITS);
+  uint8_t Position = 0;
+  while (DigitCount > 0) {
+    DigitCount--;
+    freq[Position] = Digits[DigitCount];
+    Position++;
+  }
+  freq[Position] = '.';
+  Position++;
+  for (int i = (MAX2870_DECIMAL_PLACES - 1); i >= 0; i--) {
+    freq[(Position + i)] = '0' + (DecimalPart % 10);
+    DecimalPart /= 10;
+  }
+  freq[(Position + MAX2870_DECIMAL_PLACES)] = 0x00;
+}
+
+template <class Transport>
+void MAX2870Device<Transport>::init(uint8_t SSpin, uint8_t LockPinNumber, bool Lock_Pin_Used, uint8_t CEpinNumber, bool CE_Pin_Used)
+{
+  MAX2870_RegsWritten = false; // the first write will include all registers
+  MAX2870_Transport.begin(SSpin);
+  if (CE_Pin_Used == true) {
+    pinMode(CEpinNumber, OUTPUT) ;
+  }
+  if (Lock_Pin_Used == true) {
+    pinMode(LockPinNumber, INPUT_PULLUP) ;
+  }
+  MAX2870_PIN_LD = LockPinNumber;
+  MAX2870_LockPinUsed = Lock_Pin_Used;
+  MAX2870_LockPending = false;
+}
+
+template <class Transport>
+int MAX2870Device<Transport>::SetStepFreq(uint32_t value) {
+  if (value > ReadPFDfreq()) {
+    return MAX2870_ERROR_STEP_FREQUENCY_EXCEEDS_PFD;
+  }
+  uint16_t Rvalue = ReadR();
+  if (Rvalue == 0 || (MAX2870_reffreq % value) != 0) {
+    return MAX2870_ERROR_PFD_AND_STEP_FREQUENCY_HAS_REMAINDER;
+  }
+  MAX2870_ChanStep = value;
+  return MAX2870_ERROR_NONE;
+}
+
+template <class Transport>
+int MAX2870Device<Transport>::setf(const char *freq, uint8_t PowerLevel, uint8_t AuxPowerLevel, uint8_t AuxFrequencyDivider, bool PrecisionFrequency, uint32_t MaximumFrequencyError, uint32_t CalculationTimeout) {
+  // decimal places below 1 Hz are ignored other than for the upper frequency limit - the caller's string is left untouched
+  uint64_t FrequencyHz = 0;
+  bool FrequencyHasDecimals = false;
+  uint8_t FrequencyPointer = 0;
+  while (freq[FrequencyPointer] >= '0' && freq[FrequencyPointer] <= '9') {
+    if (FrequencyHz <= 6000000000ULL) { // anything larger is out of range and must not overflow
+      FrequencyHz *= 10;
+      FrequencyHz += (freq[FrequencyPointer] - '0');
+    }
+    FrequencyPointer++;
+  }
+  if (freq[FrequencyPointer] == '.') {
+    FrequencyPointer++;
+    while (freq[FrequencyPointer] >= '0' && freq[FrequencyPointer] <= '9') {
+      if (freq[FrequencyPointer] != '0') {
+        FrequencyHasDecimals = true;
+      }
+      FrequencyPointer++;
+    }
+  }
+  if (FrequencyHz == 6000000000ULL && FrequencyHasDecimals == true) { // just above the upper frequency limit
+    FrequencyHz++;
+  }
+  return SetFrequency(FrequencyHz, 1, PowerLevel, AuxPowerLevel, AuxFrequencyDivider, PrecisionFrequency, MaximumFrequencyError, CalculationTimeout);
+}
+
+template <class Transport>
+int MAX2870Device<Transport>::setf(uint64_t FrequencyHz, uint8_t PowerLevel, uint8_t AuxPowerLevel, uint8_t AuxFrequencyDivider, bool PrecisionFrequency, uint32_t MaximumFrequencyError, uint32_t CalculationTimeout) {
+  return SetFrequency(FrequencyHz, 1, PowerLevel, AuxPowerLevel, AuxFrequencyDivider, PrecisionFrequency, MaximumFrequencyError, CalculationTimeout);
+}
+
+template <class Transport>
+int MAX2870Device<Transport>::setfMilliHz(uint64_t FrequencyMilliHz, uint8_t PowerLevel, uint8_t AuxPowerLevel, uint8_t AuxFrequencyDivider, bool PrecisionFrequency, uint32_t MaximumFrequencyError, uint32_t CalculationTimeout) {
+  return SetFrequency(FrequencyMilliHz, 1000, PowerLevel, AuxPowerLevel, AuxFrequencyDivider, PrecisionFrequency, MaximumFrequencyError, CalculationTimeout);
+}
+
+template <class Transport>
+int MAX2870Device<Transport>::setfFast(uint64_t FrequencyHz) {
+  // fractional mode with the unreduced channel step MOD so that a retune within the same RF divider band only changes R0
+  if (ReadPFDfreq() == 0) return MAX2870_ERROR_ZERO_PFD_FREQUENCY;
+  if (FrequencyHz > 6000000000ULL || FrequencyHz < 23437500ULL) return MAX2870_ERROR_RF_FREQUENCY;
+  uint64_t PFDnumerator = MAX2870_reffreq;
+  PFDnumerator *= (1 + ReadRefDoubler());
+  uint32_t PFDdenominator = ReadR();
+  PFDdenominator *= (1 + ReadRDIV2());
+  uint64_t StepDenominator = (uint64_t)MAX2870_ChanStep * PFDdenominator;
+  if (StepDenominator == 0 || (PFDnumerator % StepDenominator) != 0) return MAX2870_ERROR_PFD_AND_STEP_FREQUENCY_HAS_REMAINDER;
+  if ((FrequencyHz % MAX2870_ChanStep) != 0) return MAX2870_ERROR_RF_FREQUENCY_AND_STEP_FREQUENCY_HAS_REMAINDER;
+  uint32_t MAX2870_Mod = PFDnumerator / StepDenominator;
+  if (MAX2870_Mod < 2 || MAX2870_Mod > 4095) return MAX2870_ERROR_MOD_RANGE;
+  if ((PFDnumerator / PFDdenominator) > MAX2870_PFD_MAX_FRAC) return MAX2870_ERROR_PFD_EXCEEDED_WITH_FRACTIONAL_MODE;
+  uint8_t MAX2870_RfDivSel = SelectOutputDivider(FrequencyHz, 1);
+  uint64_t VCOnumerator = FrequencyHz * (1 << MAX2870_RfDivSel) * PFDdenominator;
+  uint32_t MAX2870_N_Int = VCOnumerator / PFDnumerator;
+  uint32_t MAX2870_Frac = (VCOnumerator % PFDnumerator) / StepDenominator; // exact as both the VCO and PFD are multiples of the channel step
+  if (MAX2870_N_Int < 19 || MAX2870_N_Int > 4091) return MAX2870_ERROR_N_RANGE_FRAC;
+  // the PFD may have changed with setrf()/setfDirect() since the last setf() - R2/R4 are only written when these change
+  if ((PFDnumerator / PFDdenominator) > 32000000UL) { // lock detect speed adjustment as per setf()
+    MAX2870Field_LDS::Write(MAX2870_R, 1);
+  }
+  else {
+    MAX2870Field_LDS::Write(MAX2870_R, 0);
+  }
+  SetBandSelectDivider(MAX2870_R);
+  PackFrequency(MAX2870_R, MAX2870_N_Int, MAX2870_Mod, MAX2870_Frac, MAX2870_RfDivSel, true);
+  MAX2870_FrequencyError = 0;
+  return WriteRegs();
+}
+
+template <class Transport>
+int MAX2870Device<Transport>::planSweep(uint64_t StartFrequency, uint64_t StopFrequency, uint64_t StepFrequency, uint32_t *regs, uint16_t MaximumSteps, uint16_t *StepsPlanned) {
+  return PlanSweep(StartFrequency, StopFrequency, StepFrequency, regs, NULL, MaximumSteps, StepsPlanned);
+}
+
+template <class Transport>
+int MAX2870Device<Transport>::planSweepCompact(uint64_t StartFrequency, uint64_t StopFrequency, uint64_t StepFrequency, MAX2870CompactStep *steps, uint16_t MaximumSteps, uint16_t *StepsPlanned) {
+  return PlanSweep(StartFrequency, StopFrequency, StepFrequency, NULL, steps, MaximumSteps, StepsPlanned);
+}
+
+template <class Transport>
+int MAX2870Device<Transport>::PlanSweep(uint64_t StartFrequency, uint64_t StopFrequency, uint64_t StepFrequency, uint32_t *regs, MAX2870CompactStep *steps, uint16_t MaximumSteps, uint16_t *StepsPlanned) {
+  // registers for each step are as setf() in channel step mode would write them at the current power levels - either regs or steps is used
+  *StepsPlanned = 0;
+  if (StartFrequency > StopFrequency) return MAX2870_ERROR_SWEEP_RANGE;
+  SweepState Sweep = {};
+  int ErrorCode = SweepBegin(Sweep, StartFrequency, StepFrequency);
+  if (ErrorCode != MAX2870_ERROR_NONE) {
+    return ErrorCode;
+  }
+  uint32_t RegisterTemplate[MAX2870_RegsToWrite];
+  for (int i = 0; i < (int)MAX2870_RegsToWrite; i++) {
+    RegisterTemplate[i] = MAX2870_R[i];
+  }
+  if (Sweep.PFDFrequency > 32000000UL) { // lock detect speed adjustment as per setf()
+    MAX2870Field_LDS::Write(RegisterTemplate, 1);
+  }
+  else {
+    MAX2870Field_LDS::Write(RegisterTemplate, 0);
+  }
+  SetBandSelectDivider(RegisterTemplate);
+  SetFastLockDivider(RegisterTemplate);
+  int32_t LargestFrequencyError = 0;
+  while (*StepsPlanned < MaximumSteps && Sweep.Frequency <= StopFrequency) {
+    uint32_t N_Int;
+    uint32_t Mod;
+    uint32_t Frac;
+    uint8_t RfDivSel;
+    ErrorCode = SweepStep(Sweep, N_Int, Mod, Frac, RfDivSel);
+    if (ErrorCode != MAX2870_ERROR_NONE) {
+      return ErrorCode;
+    }
+    if (regs != NULL) {
+      uint32_t *StepRegs = &regs[(*StepsPlanned * MAX2870_RegsToWrite)];
+      for (int i = 0; i < (int)MAX2870_RegsToWrite; i++) {
+        StepRegs[i] = RegisterTemplate[i];
+      }
+      PackFrequency(StepRegs, N_Int, Mod, Frac, RfDivSel, (Frac != 0));
+    }
+    else {
+      PackFrequency(RegisterTemplate, N_Int, Mod, Frac, RfDivSel, (Frac != 0));
+      steps[*StepsPlanned].R0 = RegisterTemplate[0x00];
+      steps[*StepsPlanned].ModDivider = (Mod | ((uint16_t)RfDivSel << 12));
+    }
+    if (abs(Sweep.FrequencyError) > abs(LargestFrequencyError)) {
+      LargestFrequencyError = Sweep.FrequencyError;
+    }
+    (*StepsPlanned)++;
+  }
+  MAX2870_FrequencyError = LargestFrequencyError;
+  if (LargestFrequencyError != 0) {
+    return MAX2870_WARNING_FREQUENCY_ERROR;
+  }
+  return MAX2870_ERROR_NONE;
+}
+
+template <class Transport>
+int MAX2870Device<Transport>::startSweep(uint64_t StartFrequency, uint64_t StopFrequency, uint64_t StepFrequency, uint32_t DwellTime, bool Repeat) {
+  return StartSweep(StartFrequency, StopFrequency, StepFrequency, false, 0, DwellTime, Repeat);
+}
+
+template <class Transport>
+int MAX2870Device<Transport>::startSweepLocked(uint64_t StartFrequency, uint64_t StopFrequency, uint64_t StepFrequency, uint32_t SettleTime, uint32_t DwellTime, bool Repeat) {
+  // without the lock pin each step dwells for DwellTime as per startSweep()
+  return StartSweep(StartFrequency, StopFrequency, StepFrequency, MAX2870_LockPinUsed, SettleTime, DwellTime, Repeat);
+}
+
+template <class Transport>
+int MAX2870Device<Transport>::StartSweep(uint64_t StartFrequency, uint64_t StopFrequency, uint64_t StepFrequency, bool LockGated, uint32_t SettleTime, uint32_t DwellTime, bool Repeat) {
+  // registers for each step are as planSweepCompact() - only MAX2870_SWEEP_RING_SIZE steps are kept so the length of the sweep is not limited by RAM
+  stopSweep();
+  if (StartFrequency > StopFrequency) return MAX2870_ERROR_SWEEP_RANGE;
+  int ErrorCode = SweepBegin(MAX2870_Sweep, StartFrequency, StepFrequency);
+  if (ErrorCode != MAX2870_ERROR_NONE) {
+    return ErrorCode;
+  }
+  if (MAX2870_Sweep.PFDFrequency > 32000000UL) { // lock detect speed adjustment as per setf()
+    MAX2870Field_LDS::Write(MAX2870_R, 1);
+  }
+  else {
+    MAX2870Field_LDS::Write(MAX2870_R, 0);
+  }
+  SetBandSelectDivider(MAX2870_R);
+  SetFastLockDivider(MAX2870_R);
+  MAX2870_SweepStart = StartFrequency;
+  MAX2870_SweepStop = StopFrequency;
+  MAX2870_SweepDwell = DwellTime;
+  MAX2870_SweepSettle = SettleTime;
+  MAX2870_SweepLockGated = LockGated;
+  MAX2870_SweepLocked = false;
+  MAX2870_SweepRepeat = Repeat;
+  MAX2870_SweepCalculated = false;
+  MAX2870_SweepStepsWritten = 0;
+  MAX2870_SweepUnderruns = 0;
+  MAX2870_SweepLockTimeouts = 0;
+  MAX2870_FrequencyError = 0;
+  for (int i = 0; i < MAX2870_SWEEP_RING_SIZE; i++) {
+    ErrorCode = FillSweepRing();
+    if (ErrorCode != MAX2870_ERROR_NONE) {
+      stopSweep();
+      return ErrorCode;
+    }
+  }
+  MAX2870_SweepRunning = true;
+  MAX2870_SweepNextStepTime = micros(); // the first step is written immediately
+  return serviceSweep();
+}
+
+template <class Transport>
+int MAX2870Device<Transport>::serviceSweep() {
+  // writes the next step when the current step has dwelled and then calculates no more than one step so that each call returns quickly
+  if (MAX2870_SweepRunning == false) {
+    return MAX2870_ERROR_NONE;
+  }
+  serviceFastLock();
+  int ErrorCode;
+  if (MAX2870_SweepLockGated == true && MAX2870_SweepLocked == false) {
+    uint8_t LockStatus = serviceLock();
+    if (LockStatus == MAX2870_LOCK_STATUS_LOCKED || (LockStatus == MAX2870_LOCK_STATUS_IDLE && digitalRead(MAX2870_PIN_LD) == HIGH)) { // IDLE after a step which did not require R0 to be written or after MAX2870_LOCK_TIMEOUT
+      MAX2870_SweepLocked = true;
+      uint32_t SettledTime = (micros() + MAX2870_SweepSettle);
+      if ((int32_t)(SettledTime - MAX2870_SweepNextStepTime) < 0) {
+        MAX2870_SweepNextStepTime = SettledTime;
+      }
+    }
+  }
+  uint32_t CurrentTime = micros();
+  if ((int32_t)(CurrentTime - MAX2870_SweepNextStepTime) >= 0) {
+    if (MAX2870_SweepRingCount == 0 && MAX2870_SweepCalculated == false) { // calculation has fallen behind the dwell time
+      MAX2870_SweepUnderruns++;
+      ErrorCode = FillSweepRing();
+      if (ErrorCode != MAX2870_ERROR_NONE) {
+        stopSweep();
+        return ErrorCode;
+      }
+    }
+    if (MAX2870_SweepRingCount == 0) { // end of the sweep
+      stopSweep();
+      return MAX2870_ERROR_NONE;
+    }
+    MAX2870CompactStep *step = &MAX2870_SweepRing[MAX2870_SweepRingHead];
+    ErrorCode = WriteCompactStep(step->R0, step->ModDivider);
+    if (ErrorCode != MAX2870_ERROR_NONE) { // the step stays in the ring and is written by the next call
+      return ErrorCode;
+    }
+    MAX2870_SweepRingHead = ((MAX2870_SweepRingHead + 1) % MAX2870_SWEEP_RING_SIZE);
+    MAX2870_SweepRingCount--;
+    MAX2870_SweepStepsWritten++;
+    if (MAX2870_SweepLockGated == true) { // DwellTime is the longest time to wait for lock
+      if (MAX2870_SweepLocked == false && MAX2870_SweepStepsWritten > 1) {
+        MAX2870_SweepLockTimeouts++;
+      }
+      MAX2870_SweepLocked = false;
+      MAX2870_SweepNextStepTime = (micros() + MAX2870_SweepDwell);
+    }
+    else {
+      MAX2870_SweepNextStepTime += MAX2870_SweepDwell; // fixed step rate regardless of when serviceSweep() is called
+      if ((int32_t)(CurrentTime - MAX2870_SweepNextStepTime) >= 0) { // more than one dwell behind - restart the step rate from this step
+        MAX2870_SweepNextStepTime = (CurrentTime + MAX2870_SweepDwell);
+      }
+    }
+  }
+  ErrorCode = FillSweepRing();
+  if (ErrorCode != MAX2870_ERROR_NONE) {
+    stopSweep();
+  }
+  return ErrorCode;
+}
+
+template <class Transport>
+void MAX2870Device<Transport>::stopSweep() {
+  MAX2870_SweepRunning = false;
+  MAX2870_SweepRingHead = 0;
+  MAX2870_SweepRingCount = 0;
+}
+
+template <class Transport>
+int MAX2870Device<Transport>::FillSweepRing() {
+  // calculates the next step into the ring if there is space - MAX2870_FrequencyError is the largest frequency error since startSweep()
+  if (MAX2870_SweepRingCount >= MAX2870_SWEEP_RING_SIZE || MAX2870_SweepCalculated == true) {
+    return MAX2870_ERROR_NONE;
+  }
+  int ErrorCode;
+  if (MAX2870_Sweep.Frequency > MAX2870_SweepStop) { // repeat from the start frequency
+    ErrorCode = SweepBegin(MAX2870_Sweep, MAX2870_SweepStart, MAX2870_Sweep.StepFrequency);
+    if (ErrorCode != MAX2870_ERROR_NONE) {
+      return ErrorCode;
+    }
+  }
+  uint32_t N_Int;
+  uint32_t Mod;
+  uint32_t Frac;
+  uint8_t RfDivSel;
+  ErrorCode = SweepStep(MAX2870_Sweep, N_Int, Mod, Frac, RfDivSel);
+  if (ErrorCode != MAX2870_ERROR_NONE) {
+    return ErrorCode;
+  }
+  if (abs(MAX2870_Sweep.FrequencyError) > abs(MAX2870_FrequencyError)) {
+    MAX2870_FrequencyError = MAX2870_Sweep.FrequencyError;
+  }
+  MAX2870CompactStep *step = &MAX2870_SweepRing[((MAX2870_SweepRingHead + MAX2870_SweepRingCount) % MAX2870_SWEEP_RING_SIZE)];
+  if (Frac != 0) {
+    step->R0 = MAX2870Field_INT::Set(MAX2870Field_N::Set(MAX2870Field_FRAC::Set(MAX2870_R[0x00], Frac), N_Int), 0); // fractional-n mode
+  }
+  else {
+    step->R0 = MAX2870Field_INT::Set(MAX2870Field_N::Set(MAX2870Field_FRAC::Set(MAX2870_R[0x00], Frac), N_Int), 1); // integer-n mode
+  }
+  step->ModDivider = (Mod | ((uint16_t)RfDivSel << 12));
+  MAX2870_SweepRingCount++;
+  if (MAX2870_SweepRepeat == false && MAX2870_Sweep.Frequency > MAX2870_SweepStop) {
+    MAX2870_SweepCalculated = true;
+  }
+  return MAX2870_ERROR_NONE;
+}
+
+template <class Transport>
+int MAX2870Device<Transport>::startPlayback(const uint32_t *regs, uint16_t Steps, const uint16_t *DwellTicks, uint16_t DwellTime, uint32_t TickPeriod, bool Repeat) {
+  return StartPlayback(regs, NULL, Steps, DwellTicks, DwellTime, TickPeriod, Repeat);
+}
+
+template <class Transport>
+int MAX2870Device<Transport>::startPlaybackCompact(const MAX2870CompactStep *steps, uint16_t Steps, const uint16_t *DwellTicks, uint16_t DwellTime, uint32_t TickPeriod, bool Repeat) {
+  return StartPlayback(NULL, steps, Steps, DwellTicks, DwellTime, TickPeriod, Repeat);
+}
+
+template <class Transport>
+int MAX2870Device<Transport>::StartPlayback(const uint32_t *regs, const MAX2870CompactStep *steps, uint16_t Steps, const uint16_t *DwellTicks, uint16_t DwellTime, uint32_t TickPeriod, bool Repeat) {
+  // the table (and DwellTicks) must remain valid until playback has stopped - either regs or steps is used
+  stopPlayback();
+  if (Steps == 0 || (regs == NULL && steps == NULL)) return MAX2870_ERROR_PLAYBACK_LENGTH;
+  if (MAX2870_WriteMode == MAX2870_WRITE_MODE_QUEUE || MAX2870_VCOCacheMode == MAX2870_VCO_CACHE_LEARN) return MAX2870_ERROR_PLAYBACK_WRITE_MODE; // tick() cannot wait for serviceQueue() or search for a VCO band
+  if (steps != NULL && (MAX2870_VCOCacheMode != MAX2870_VCO_CACHE_OFF || MAX2870_FastLockMode == MAX2870_FAST_LOCK_HARDWARE)) return MAX2870_ERROR_PLAYBACK_WRITE_MODE; // PackCompactStep() from tick() would divide in 64 bits for the VCO bucket and the fast lock clock divider
+  MAX2870_PlaybackRegs = regs;
+  MAX2870_PlaybackSteps = steps;
+  MAX2870_PlaybackDwellTicks = DwellTicks;
+  MAX2870_PlaybackDwell = DwellTime;
+  MAX2870_PlaybackLength = Steps;
+  MAX2870_PlaybackIndex = 0;
+  MAX2870_PlaybackTicksRemaining = 1; // the first step is written on the next tick
+  MAX2870_PlaybackTickPeriod = TickPeriod;
+  MAX2870_PlaybackJitterMinimum = 0;
+  MAX2870_PlaybackJitterMaximum = 0;
+  MAX2870_PlaybackWriteTimeMinimum = 0;
+  MAX2870_PlaybackWriteTimeMaximum = 0;
+  MAX2870_PlaybackWriteTimeTotal = 0;
+  MAX2870_PlaybackRegistersWritten = 0;
+  MAX2870_PlaybackRepeat = Repeat;
+  MAX2870_PlaybackRunOrder = MAX2870_PlaybackOrder;
+  if (MAX2870_PlaybackRunOrder == MAX2870_PLAYBACK_ORDER_RANDOM) { // the smallest LFSR with a state for every step
+    uint8_t Bits = 2;
+    while (Bits < 16 && ((1UL << Bits) - 1) < Steps) {
+      Bits++;
+    }
+    MAX2870_PlaybackLFSRMask = ((1UL << Bits) - 1);
+    MAX2870_PlaybackLFSRTaps = MAX2870_ReadFlashWord(&MAX2870_LFSR_TAPS[(Bits - 2)]);
+    MAX2870_PlaybackLFSR = (MAX2870_PlaybackSeed & MAX2870_PlaybackLFSRMask);
+    if (MAX2870_PlaybackLFSR == 0) { // the LFSR never leaves the all zero state
+      MAX2870_PlaybackLFSR = 1;
+    }
+    MAX2870_PlaybackLFSRFirst = MAX2870_PlaybackLFSR;
+    if ((uint16_t)(MAX2870_PlaybackLFSR - 1) >= Steps) { // the first pass starts from the first state after the seed with a step
+      AdvancePlayback();
+      MAX2870_PlaybackLFSRFirst = MAX2870_PlaybackLFSR;
+    }
+    MAX2870_PlaybackIndex = (MAX2870_PlaybackLFSR - 1);
+  }
+  MAX2870_PlaybackStepsWritten = 0;
+  MAX2870_PlaybackRunning = true; // last as tick() may be called at any time
+  return MAX2870_ERROR_NONE;
+}
+
+template <class Transport>
+void MAX2870Device<Transport>::tick() {
+  // the step is written at the start of a tick so that step timing only depends on the timer and not on the main loop
+  if (MAX2870_PlaybackRunning == false) {
+    return;
+  }
+  if (MAX2870_PlaybackTicksRemaining > 1) {
+    serviceFastLock(); // between steps so that it does not add to the step timing
+    MAX2870_PlaybackTicksRemaining--;
+    return;
+  }
+  uint32_t WriteStartTime = micros();
+  if (MAX2870_PlaybackRegs != NULL) {
+    const uint32_t *StepRegs = &MAX2870_PlaybackRegs[(MAX2870_PlaybackIndex * MAX2870_RegsToWrite)];
+    for (int i = 0; i < (int)MAX2870_RegsToWrite; i++) {
+      MAX2870_R[i] = StepRegs[i];
+    }
+  }
+  else {
+    PackCompactStep(MAX2870_PlaybackSteps[MAX2870_PlaybackIndex].R0, MAX2870_PlaybackSteps[MAX2870_PlaybackIndex].ModDivider);
+  }
+  WriteRegisterSet(MAX2870_R); // directly as WriteRegs() may queue or learn - both refused by startPlayback()
+  uint32_t CurrentTime = micros(); // when the last register has been written
+  uint32_t WriteTime = (CurrentTime - WriteStartTime);
+  if (MAX2870_PlaybackStepsWritten == 0 || WriteTime < MAX2870_PlaybackWriteTimeMinimum) {
+    MAX2870_PlaybackWriteTimeMinimum = WriteTime;
+  }
+  if (WriteTime > MAX2870_PlaybackWriteTimeMaximum) {
+    MAX2870_PlaybackWriteTimeMaximum = WriteTime;
+  }
+  MAX2870_PlaybackWriteTimeTotal += WriteTime;
+  MAX2870_PlaybackRegistersWritten += MAX2870_RegsWrittenCount;
+  if (MAX2870_PlaybackStepsWritten != 0 && MAX2870_PlaybackTickPeriod != 0) { // step to step time against the dwell of the previous step
+    int32_t Jitter = (int32_t)((CurrentTime - MAX2870_PlaybackLastStepTime) - ((uint32_t)MAX2870_PlaybackPreviousDwell * MAX2870_PlaybackTickPeriod));
+    if (MAX2870_PlaybackStepsWritten == 1 || Jitter < MAX2870_PlaybackJitterMinimum) {
+      MAX2870_PlaybackJitterMinimum = Jitter;
+    }
+    if (MAX2870_PlaybackStepsWritten == 1 || Jitter > MAX2870_PlaybackJitterMaximum) {
+      MAX2870_PlaybackJitterMaximum = Jitter;
+    }
+  }
+  MAX2870_PlaybackLastStepTime = CurrentTime;
+  MAX2870_PlaybackStepsWritten++;
+  if (MAX2870_PlaybackDwellTicks != NULL) {
+    MAX2870_PlaybackTicksRemaining = MAX2870_PlaybackDwellTicks[MAX2870_PlaybackIndex];
+  }
+  else {
+    MAX2870_PlaybackTicksRemaining = MAX2870_PlaybackDwell;
+  }
+  if (MAX2870_PlaybackTicksRemaining == 0) { // no less than one tick
+    MAX2870_PlaybackTicksRemaining = 1;
+  }
+  MAX2870_PlaybackPreviousDwell = MAX2870_PlaybackTicksRemaining;
+  if (AdvancePlayback() == false && MAX2870_PlaybackRepeat == false) { // the last step remains on the output
+    MAX2870_PlaybackRunning = false;
+  }
+}
+
+template <class Transport>
+bool MAX2870Device<Transport>::AdvancePlayback() {
+  // moves to the next step in the playback order - returns false when the pass has ended with the first step of the next pass
+  if (MAX2870_PlaybackRunOrder == MAX2870_PLAYBACK_ORDER_SEQUENTIAL) {
+    MAX2870_PlaybackIndex++;
+    if (MAX2870_PlaybackIndex >= MAX2870_PlaybackLength) {
+      MAX2870_PlaybackIndex = 0;
+      return false;
+    }
+    return true;
+  }
+  // every nonzero state occurs once in each LFSR period and no more than bits states in a row are beyond the table as the table is longer than half the period
+  bool PassContinues = true;
+  do {
+    uint16_t Feedback = (MAX2870_PlaybackLFSR & MAX2870_PlaybackLFSRTaps);
+    Feedback ^= (Feedback >> 8);
+    Feedback ^= (Feedback >> 4);
+    Feedback ^= (Feedback >> 2);
+    Feedback ^= (Feedback >> 1);
+    MAX2870_PlaybackLFSR = (((MAX2870_PlaybackLFSR << 1) | (Feedback & 0x01)) & MAX2870_PlaybackLFSRMask);
+    if (MAX2870_PlaybackLFSR == MAX2870_PlaybackLFSRFirst) {
+      PassContinues = false;
+    }
+  } while ((uint16_t)(MAX2870_PlaybackLFSR - 1) >= MAX2870_PlaybackLength);
+  MAX2870_PlaybackIndex = (MAX2870_PlaybackLFSR - 1);
+  return PassContinues;
+}
+
+template <class Transport>
+int MAX2870Device<Transport>::setPlaybackOrder(uint8_t Order, uint16_t Seed) {
+  if (Order == MAX2870_PLAYBACK_ORDER_SEQUENTIAL || Order == MAX2870_PLAYBACK_ORDER_RANDOM) {
+    MAX2870_PlaybackOrder = Order;
+    MAX2870_PlaybackSeed = Seed;
+    return MAX2870_ERROR_NONE;
+  }
+  else {
+    return MAX2870_ERROR_PLAYBACK_ORDER;
+  }
+}
+
+template <class Transport>
+void MAX2870Device<Transport>::stopPlayback() {
+  MAX2870_PlaybackRunning = false;
+}
+
+template <class Transport>
+void MAX2870Device<Transport>::ReadPlaybackStatistics(uint32_t *StepsWritten, int32_t *MinimumJitter, int32_t *MaximumJitter) {
+  // jitter is the difference between the measured step to step time and the dwell time over all steps since the start of playback - interrupts are disabled while reading as tick() may change these at any time
+  noInterrupts();
+  *StepsWritten = MAX2870_PlaybackStepsWritten;
+  *MinimumJitter = MAX2870_PlaybackJitterMinimum;
+  *MaximumJitter = MAX2870_PlaybackJitterMaximum;
+  interrupts();
+}
+
+template <class Transport>
+void MAX2870Device<Transport>::ReadPlaybackStatistics(MAX2870PlaybackStatistics *Statistics) {
+  // one consistent copy with interrupts disabled - the mean is divided afterwards so that the 64 bit division does not delay tick()
+  noInterrupts();
+  Statistics->StepsWritten = MAX2870_PlaybackStepsWritten;
+  Statistics->MinimumJitter = MAX2870_PlaybackJitterMinimum;
+  Statistics->MaximumJitter = MAX2870_PlaybackJitterMaximum;
+  Statistics->MinimumWriteTime = MAX2870_PlaybackWriteTimeMinimum;
+  Statistics->MaximumWriteTime = MAX2870_PlaybackWriteTimeMaximum;
+  uint64_t WriteTimeTotal = MAX2870_PlaybackWriteTimeTotal;
+  Statistics->RegistersWritten = MAX2870_PlaybackRegistersWritten;
+  interrupts();
+  if (Statistics->StepsWritten != 0) {
+    Statistics->MeanWriteTime = (WriteTimeTotal / Statistics->StepsWritten);
+  }
+  else {
+    Statistics->MeanWriteTime = 0;
+  }
+}
+
+template <class Transport>
+int MAX2870Device<Transport>::SetFrequency(uint64_t Frequency, uint16_t FrequencyScale, uint8_t PowerLevel, uint8_t AuxPowerLevel, uint8_t AuxFrequencyDivider, bool PrecisionFrequency, uint32_t MaximumFrequencyError, uint32_t CalculationTimeout) {
+  //  calculate settings from freq - Frequency is in Hz when FrequencyScale is 1 or in mHz when FrequencyScale is 1000
+  if (PowerLevel > 4) return MAX2870_ERROR_POWER_LEVEL;
+  if (AuxPowerLevel > 4) return MAX2870_ERROR_AUX_POWER_LEVEL;
+  if (AuxFrequencyDivider != MAX2870_AUX_DIVIDED && AuxFrequencyDivider != MAX2870_AUX_FUNDAMENTAL) return MAX2870_ERROR_AUX_FREQ_DIVIDER;
+  if (ReadPFDfreq() == 0) return MAX2870_ERROR_ZERO_PFD_FREQUENCY;
+
+  uint32_t ReferenceFrequency = MAX2870_reffreq;
+  ReferenceFrequency /= ReadR();
+  if (PrecisionFrequency == false && MAX2870_ChanStep > 1 && (ReferenceFrequency % MAX2870_ChanStep) != 0) {
+    return MAX2870_ERROR_PFD_AND_STEP_FREQUENCY_HAS_REMAINDER;
+  }
+
+  if (Frequency > (6000000000ULL * FrequencyScale) || Frequency < (23437500ULL * FrequencyScale)) {
+    return MAX2870_ERROR_RF_FREQUENCY;
+  }
+
+  if (PrecisionFrequency == false && MAX2870_ChanStep > 1 && (Frequency % ((uint64_t)MAX2870_ChanStep * FrequencyScale)) != 0) {
+    return MAX2870_ERROR_RF_FREQUENCY_AND_STEP_FREQUENCY_HAS_REMAINDER;
+  }
+
+  uint32_t MAX2870_N_Int;
+  uint32_t MAX2870_Mod;
+  uint32_t MAX2870_Frac;
+  uint8_t MAX2870_RfDivSel;
+  if (CalculateFrequency(Frequency, FrequencyScale, PrecisionFrequency, MaximumFrequencyError, CalculationTimeout, MAX2870_N_Int, MAX2870_Mod, MAX2870_Frac, MAX2870_RfDivSel) == false) {
+    return MAX2870_ERROR_PRECISION_FREQUENCY_CALCULATION_TIMEOUT;
+  }
+  uint32_t PFDFreq = (MAX2870_reffreq * (1 + ReadRefDoubler())) / (ReadR() * (1 + ReadRDIV2())); // used for checking maximum PFD limit under Fractional Mode
+
+  int ErrorCode = ValidateFrequency(MAX2870_N_Int, MAX2870_Mod, MAX2870_Frac, PFDFreq);
+  if (ErrorCode != MAX2870_ERROR_NONE) {
+    return ErrorCode;
+  }
+
+  PackFrequency(MAX2870_R, MAX2870_N_Int, MAX2870_Mod, MAX2870_Frac, MAX2870_RfDivSel, (MAX2870_Frac != 0));
+  // (0x01, 15, 12, 1) phase
+  // (0x02, 3,1,0) counter reset
+  // (0x02, 4,1,0) cp3 state
+  // (0x02, 5,1,0) power down
+  if (PFDFreq > 32000000UL) { // lock detect speed adjustment
+    MAX2870Field_LDS::Write(MAX2870_R, 1); // Lock Detect Speed
+  }
+  else  {
+    MAX2870Field_LDS::Write(MAX2870_R, 0); // Lock Detect Speed
+  }
+  SetBandSelectDivider(MAX2870_R);
+  SetFastLockDivider(MAX2870_R);
+  // (0x02, 13,1,0) dbl buf
+  // (0x02, 26,3,0) //  muxout, not used
+  // (0x02, 29,2,0) low noise and spurs mode
+  // (0x03, 15,2,1) clk div mode
+  // (0x03, 17,1,0) reserved
+  // (0x03, 18,6,0) reserved
+  // (0x03, 24,1,0) VAS response to temperature drift
+  // (0x03, 25,1,0) VAS state machine
+  // (0x03, 26,6,0) VCO and VCO sub-band manual selection
+  if (PowerLevel == 0) {
+    MAX2870Field_RFA_EN::Write(MAX2870_R, 0);
+  }
+  else {
+    PowerLevel--;
+    MAX2870_WriteFields<MAX2870Field_RFA_EN, MAX2870Field_APWR>(MAX2870_R, 1, PowerLevel);
+  }
+  if (AuxPowerLevel == 0) {
+    MAX2870Field_RFB_EN::Write(MAX2870_R, 0);
+  }
+  else {
+    AuxPowerLevel--;
+    MAX2870_WriteFields<MAX2870Field_BPWR, MAX2870Field_RFB_EN, MAX2870Field_BDIV>(MAX2870_R, AuxPowerLevel, 1, AuxFrequencyDivider);
+  }
+  // (0x04, 10,1,0) reserved
+  // (0x04, 11,1,0) reserved
+  // (0x04, 12,8,1) Band Select Clock Divider
+  // (0x04, 20,3,0) rf divider select
+  // (0x04, 23,8,0) reserved
+  // (0x04, 24,2,1) Band Select Clock Divider MSBs
+  // (0x04, 26,6,1) reserved
+  // (0x05, 3,15,0) reserved
+  // (0x05, 18,1,0) MUXOUT pin mode
+  // (0x05, 22,2,1) lock pin function
+  // (0x05, 25,7,0) reserved
+  ErrorCode = WriteRegs();
+  if (ErrorCode != MAX2870_ERROR_NONE) {
+    return ErrorCode;
+  }
+
+  bool NegativeError = false;
+  if (MAX2870_FrequencyError < 0) { // convert to a positive for frequency error comparison with a positive value
+    MAX2870_FrequencyError ^= 0xFFFFFFFF;
+    MAX2870_FrequencyError++;
+    NegativeError = true;
+  }
+  if ((PrecisionFrequency == true && (uint32_t)MAX2870_FrequencyError > MaximumFrequencyError) || (PrecisionFrequency == false && MAX2870_FrequencyError != 0)) {
+    if (NegativeError == true) { // convert back to negative if changed from negative to positive for frequency error comparison with a positive value
+      MAX2870_FrequencyError ^= 0xFFFFFFFF;
+      MAX2870_FrequencyError++;
+    }
+    return MAX2870_WARNING_FREQUENCY_ERROR;
+  }
+
+  return MAX2870_ERROR_NONE; // ok
+}
+
+template <class Transport>
+int MAX2870Device<Transport>::ValidateFrequency(uint32_t N_Int, uint32_t &Mod, uint32_t Frac, uint32_t PFDFreq) {
+  if (Frac == 0) { // correct the MOD to the minimum required value
+    Mod = 2;
+  }
+
+  if ( Mod < 2 || Mod > 4095) {
+    return MAX2870_ERROR_MOD_RANGE;
+  }
+
+  if ( (uint32_t) Frac > (Mod - 1) ) {
+    return MAX2870_ERROR_FRAC_RANGE;
+  }
+
+  if (Frac == 0 && (N_Int < 16  || N_Int > 65535)) {
+    return MAX2870_ERROR_N_RANGE;
+  }
+
+  if (Frac != 0 && (N_Int < 19  || N_Int > 4091)) {
+    return MAX2870_ERROR_N_RANGE_FRAC;
+  }
+
+  if (Frac != 0 && PFDFreq > MAX2870_PFD_MAX_FRAC) {
+    return MAX2870_ERROR_PFD_EXCEEDED_WITH_FRACTIONAL_MODE;
+  }
+
+  return MAX2870_ERROR_NONE;
+}
+
+template <class Transport>
+uint8_t MAX2870Device<Transport>::SelectOutputDivider(uint64_t Frequency, uint16_t FrequencyScale) {
+  // returns the RF divider select (power of 2) which keeps the VCO within 3 to 6 GHz
+  uint8_t localosc_ratio = (3000000000ULL * FrequencyScale) / Frequency;
+  uint8_t MAX2870_outdiv = 1 ;
+  uint8_t RfDivSel = 0 ;
+  if (Frequency > (23437500ULL * FrequencyScale)) {
+    while (MAX2870_outdiv <= localosc_ratio && MAX2870_outdiv <= 64) {
+      MAX2870_outdiv *= 2;
+      RfDivSel++;
+    }
+  }
+  else {
+    RfDivSel = 7;
+  }
+  return RfDivSel;
+}
+
+template <class Transport>
+void MAX2870Device<Transport>::PackFrequency(uint32_t *regs, uint32_t N_Int, uint32_t Mod, uint32_t Frac, uint8_t RfDivSel, bool FractionalMode) {
+  // one read-modify-write for each register
+  if (FractionalMode == false) {
+    MAX2870_WriteFields<MAX2870Field_FRAC, MAX2870Field_N, MAX2870Field_INT>(regs, Frac, N_Int, 1); // integer-n mode
+    MAX2870_WriteFields<MAX2870Field_M, MAX2870Field_CPL, MAX2870Field_CPOC>(regs, Mod, 0, 1); // Charge Pump Linearity and Output Clamp
+    MAX2870Field_LDF::Write(regs, 1); // Lock Detect Function, int-n mode
+    MAX2870Field_F01::Write(regs, 1); // integer-n mode
+  }
+  else {
+    MAX2870_WriteFields<MAX2870Field_FRAC, MAX2870Field_N, MAX2870Field_INT>(regs, Frac, N_Int, 0); // fractional-n mode
+    MAX2870_WriteFields<MAX2870Field_M, MAX2870Field_CPL, MAX2870Field_CPOC>(regs, Mod, 1, 0); // Charge Pump Linearity and Output Clamp
+    MAX2870Field_LDF::Write(regs, 0); // Lock Detect Function, frac-n mode
+    MAX2870Field_F01::Write(regs, 0); // fractional-n mode
+  }
+  MAX2870Field_DIVA::Write(regs, RfDivSel); // rf divider select
+  SetFastLockDivider(regs); // the fast lock timeout depends on MOD
+  if (MAX2870_VCOCacheMode != MAX2870_VCO_CACHE_OFF) {
+    ApplyVCOCache(regs);
+  }
+}
+
+// frequency error in Hz from Numerator / Divisor (Divisor > 0) rounded to the nearest Hz with halves away from 0 - C division rounds towards 0 so a negative error is rounded as a positive error
+static inline int32_t RoundedFrequencyError(int64_t Numerator, int64_t Divisor) {
+  if (Numerator < 0) {
+    return -(int32_t)((((-Numerator) * 2) + Divisor) / (Divisor * 2));
+  }
+  return (int32_t)(((Numerator * 2) + Divisor) / (Divisor * 2));
+}
+
+// binary (Stein) GCD - no more than 64 shift/subtract iterations for any 32 bit values
+static inline uint32_t BinaryGCD(uint32_t a, uint32_t b) {
+  if (a == 0) {
+    return b;
+  }
+  if (b == 0) {
+    return a;
+  }
+  uint8_t CommonShift = 0;
+  while (((a | b) & 1) == 0) { // common powers of 2
+    a >>= 1;
+    b >>= 1;
+    CommonShift++;
+  }
+  while ((a & 1) == 0) {
+    a >>= 1;
+  }
+  while (b != 0) { // a is always odd from here
+    while ((b & 1) == 0) {
+      b >>= 1;
+    }
+    if (a > b) {
+      uint32_t temp = a;
+      a = b;
+      b = temp;
+    }
+    b -= a;
+  }
+  return (a << CommonShift);
+}
+
+// FRAC/MOD searches where the N remainder is Remainder / PFDnumerator (always < 1)
+// both walk the Stern-Brocot tree one continued fraction term per iteration so that no more than a few dozen iterations are required for a MOD of up to 4095
+
+// smallest MOD (and its FRAC) where |(Remainder * MOD) - (FRAC * PFDnumerator)| < (ErrorWindow * MOD) with FRAC < MOD - returns false if MOD would exceed 4095
+static inline bool SimplestFraction(uint64_t Remainder, uint64_t PFDnumerator, uint64_t ErrorWindow, uint32_t &Frac, uint32_t &Mod) {
+  if (Remainder < ErrorWindow) { // FRAC of 0 is within the window
+    Frac = 0;
+    Mod = 1;
+    return true;
+  }
+  uint64_t LowerNumerator = Remainder - ErrorWindow; // lower limit is LowerNumerator / PFDnumerator
+  uint64_t UpperNumerator = Remainder + ErrorWindow; // upper limit is UpperNumerator / UpperDenominator
+  uint64_t UpperDenominator = PFDnumerator;
+  if (UpperNumerator >= PFDnumerator) { // FRAC must be < MOD
+    UpperNumerator = 1;
+    UpperDenominator = 1;
+  }
+  uint32_t LowFrac = 0;
+  uint32_t LowMod = 1;
+  uint32_t HighFrac = 1;
+  uint32_t HighMod = 1;
+  while (true) {
+    uint32_t MediantFrac = LowFrac + HighFrac;
+    uint32_t MediantMod = LowMod + HighMod;
+    if (MediantMod > 4095) {
+      return false;
+    }
+    if ((MediantFrac * PFDnumerator) <= (LowerNumerator * MediantMod)) { // at or below the lower limit - move the lower bound up as far as possible
+      uint64_t Steps = ((LowerNumerator * LowMod) - (LowFrac * PFDnumerator)) / ((HighFrac * PFDnumerator) - (LowerNumerator * HighMod));
+      if (Steps > ((4095 - LowMod) / HighMod)) {
+        return false;
+      }
+      LowFrac += (Steps * HighFrac);
+      LowMod += (Steps * HighMod);
+    }
+    else if ((MediantFrac * UpperDenominator) >= (UpperNumerator * MediantMod)) { // at or above the upper limit - move the upper bound down as far as possible
+      uint64_t Steps = ((HighFrac * UpperDenominator) - (UpperNumerator * HighMod)) / ((UpperNumerator * LowMod) - (LowFrac * UpperDenominator));
+      if (Steps > ((4095 - HighMod) / LowMod)) {
+        return false;
+      }
+      HighFrac += (Steps * LowFrac);
+      HighMod += (Steps * LowMod);
+    }
+    else {
+      Frac = MediantFrac;
+      Mod = MediantMod;
+      return true;
+    }
+  }
+}
+
+// closest FRAC/MOD to Remainder / PFDnumerator with MOD <= 4095 and FRAC < MOD
+static inline void ClosestFraction(uint64_t Remainder, uint64_t PFDnumerator, uint32_t &Frac, uint32_t &Mod) {
+  uint32_t LowFrac = 0;
+  uint32_t LowMod = 1;
+  uint32_t HighFrac = 1;
+  uint32_t HighMod = 1;
+  while ((Remainder * LowMod) != (LowFrac * PFDnumerator)) { // stop if the lower bound is exact
+    uint32_t MediantFrac = LowFrac + HighFrac;
+    uint32_t MediantMod = LowMod + HighMod;
+    if (MediantMod > 4095) {
+      break;
+    }
+    uint64_t MediantLeft = MediantFrac * PFDnumerator;
+    uint64_t MediantRight = Remainder * MediantMod;
+    if (MediantLeft == MediantRight) { // exact
+      Frac = MediantFrac;
+      Mod = MediantMod;
+      return;
+    }
+    if (MediantLeft < MediantRight) { // below the target - move the lower bound up as far as possible without passing it
+      uint64_t Steps = ((Remainder * LowMod) - (LowFrac * PFDnumerator)) / ((HighFrac * PFDnumerator) - (Remainder * HighMod));
+      if (Steps > ((4095 - LowMod) / HighMod)) {
+        Steps = ((4095 - LowMod) / HighMod);
+      }
+      LowFrac += (Steps * HighFrac);
+      LowMod += (Steps * HighMod);
+    }
+    else { // above the target - move the upper bound down as far as possible without passing it
+      uint64_t Steps = ((HighFrac * PFDnumerator) - (Remainder * HighMod)) / ((Remainder * LowMod) - (LowFrac * PFDnumerator));
+      if (Steps > ((4095 - HighMod) / LowMod)) {
+        Steps = ((4095 - HighMod) / LowMod);
+      }
+      HighFrac += (Steps * LowFrac);
+      HighMod += (Steps * LowMod);
+    }
+  }
+  Frac = LowFrac;
+  Mod = LowMod;
+  if (HighFrac != HighMod) { // upper bound is not 1 which is not a valid FRAC/MOD
+    uint64_t LowError = ((Remainder * LowMod) - (LowFrac * PFDnumerator)) * HighMod;
+    uint64_t HighError = ((HighFrac * PFDnumerator) - (Remainder * HighMod)) * LowMod;
+    if (HighError < LowError) {
+      Frac = HighFrac;
+      Mod = HighMod;
+    }
+  }
+}
+
+// reduces a channel step FRAC/MOD by the GCD and uses the closest FRAC/MOD (or the next INT) if MOD is still greater than 4095
+static inline void ReduceChannelFraction(uint32_t &N_Int, uint32_t &Mod, uint32_t &Frac) {
+  uint32_t GCD_t = BinaryGCD(Mod, Frac);
+  if (GCD_t != 0) {
+    Mod /= GCD_t;
+    Frac /= GCD_t;
+  }
+  if (Mod > 4095) { // outside valid range - use the closest FRAC/MOD within range
+    if (Frac >= Mod) { // FRAC must be less than MOD
+      Frac = Mod - 1;
+    }
+    uint32_t TempFrac;
+    uint32_t TempMod;
+    ClosestFraction(Frac, Mod, TempFrac, TempMod);
+    uint64_t FracTimesMod = (uint64_t)Frac * TempMod;
+    uint64_t ModTimesFrac = (uint64_t)Mod * TempFrac;
+    uint64_t ClosestError;
+    if (FracTimesMod > ModTimesFrac) {
+      ClosestError = FracTimesMod - ModTimesFrac;
+    }
+    else {
+      ClosestError = ModTimesFrac - FracTimesMod;
+    }
+    if (((uint64_t)(Mod - Frac) * TempMod) < ClosestError) { // rounding up to the next INT is closer
+      N_Int++;
+      TempFrac = 0;
+      TempMod = 2;
+    }
+    Frac = TempFrac;
+    Mod = TempMod;
+  }
+}
+
+template <class Transport>
+int MAX2870Device<Transport>::SweepBegin(SweepState &Sweep, uint64_t StartFrequency, uint64_t StepFrequency) {
+  // PFD and channel step values are calculated once for the entire sweep
+  if (ReadPFDfreq() == 0) return MAX2870_ERROR_ZERO_PFD_FREQUENCY;
+  if (StepFrequency == 0) return MAX2870_ERROR_SWEEP_RANGE;
+  uint32_t ReferenceFrequency = MAX2870_reffreq;
+  ReferenceFrequency /= ReadR();
+  if (MAX2870_ChanStep > 1 && (ReferenceFrequency % MAX2870_ChanStep) != 0) {
+    return MAX2870_ERROR_PFD_AND_STEP_FREQUENCY_HAS_REMAINDER;
+  }
+  if (MAX2870_ChanStep > 1 && ((StartFrequency % MAX2870_ChanStep) != 0 || (StepFrequency % MAX2870_ChanStep) != 0)) {
+    return MAX2870_ERROR_RF_FREQUENCY_AND_STEP_FREQUENCY_HAS_REMAINDER;
+  }
+  Sweep.Frequency = StartFrequency;
+  Sweep.StepFrequency = StepFrequency;
+  Sweep.BandLimit = 0; // the RF divider band is calculated on the first step
+  Sweep.PFDnumerator = MAX2870_reffreq;
+  Sweep.PFDnumerator *= (1 + ReadRefDoubler());
+  Sweep.PFDdenominator = ReadR();
+  Sweep.PFDdenominator *= (1 + ReadRDIV2());
+  Sweep.StepDenominator = (uint64_t)MAX2870_ChanStep * Sweep.PFDdenominator;
+  Sweep.ChannelMod = Sweep.PFDnumerator / Sweep.StepDenominator;
+  Sweep.PFDFrequency = Sweep.PFDnumerator / Sweep.PFDdenominator;
+  return MAX2870_ERROR_NONE;
+}
+
+template <class Transport>
+int MAX2870Device<Transport>::SweepStep(SweepState &Sweep, uint32_t &N_Int, uint32_t &Mod, uint32_t &Frac, uint8_t &RfDivSel) {
+  // calculates the current step with the same results as setf() in channel step mode and advances to the next step
+  if (Sweep.Frequency > 6000000000ULL || Sweep.Frequency < 23437500ULL) {
+    return MAX2870_ERROR_RF_FREQUENCY;
+  }
+  uint8_t MAX2870_outdiv;
+  if (Sweep.Frequency > Sweep.BandLimit) { // first step or the next RF divider - the only divisions of the VCO are here
+    Sweep.RfDivSel = SelectOutputDivider(Sweep.Frequency, 1);
+    MAX2870_outdiv = (1 << Sweep.RfDivSel);
+    uint64_t VCOnumerator = Sweep.Frequency * MAX2870_outdiv * Sweep.PFDdenominator;
+    uint64_t VCOincrement = Sweep.StepFrequency * MAX2870_outdiv * Sweep.PFDdenominator;
+    Sweep.N_Int = VCOnumerator / Sweep.PFDnumerator;
+    Sweep.Remainder = VCOnumerator % Sweep.PFDnumerator;
+    Sweep.N_IntIncrement = VCOincrement / Sweep.PFDnumerator;
+    Sweep.RemainderIncrement = VCOincrement % Sweep.PFDnumerator;
+    if (Sweep.RfDivSel == 0) {
+      Sweep.BandLimit = 6000000000ULL;
+    }
+    else { // the RF divider select is N for frequencies above 3 GHz / (2 ^ N) up to 3 GHz / (2 ^ (N - 1))
+      Sweep.BandLimit = (3000000000ULL >> (Sweep.RfDivSel - 1));
+    }
+    // FRAC on the unreduced channel step MOD can be stepped without division when every value is a whole number of channel steps
+    Sweep.ExactChannels = ((Sweep.PFDnumerator % Sweep.StepDenominator) == 0 && (Sweep.Remainder % Sweep.StepDenominator) == 0 && (Sweep.RemainderIncrement % Sweep.StepDenominator) == 0);
+    if (Sweep.ExactChannels == true) {
+      Sweep.ChannelFrac = Sweep.Remainder / Sweep.StepDenominator;
+      Sweep.ChannelFracIncrement = Sweep.RemainderIncrement / Sweep.StepDenominator;
+    }
+  }
+  else {
+    MAX2870_outdiv = (1 << Sweep.RfDivSel);
+  }
+  RfDivSel = Sweep.RfDivSel;
+  N_Int = Sweep.N_Int;
+  Mod = Sweep.ChannelMod;
+  if (Sweep.ExactChannels == true) {
+    Frac = Sweep.ChannelFrac;
+  }
+  else {
+    Frac = ((Sweep.Remainder * MAX2870_outdiv * 2) + Sweep.StepDenominator) / (Sweep.StepDenominator * MAX2870_outdiv * 2); // rounded to the nearest step
+  }
+  ReduceChannelFraction(N_Int, Mod, Frac);
+
+  // frequency error at the RF output rounded to the nearest Hz
+  Sweep.FrequencyError = 0;
+  int64_t ErrorNumerator = (int64_t)(Sweep.PFDnumerator * Frac) - ((int64_t)Sweep.Remainder - ((int64_t)(N_Int - Sweep.N_Int) * (int64_t)Sweep.PFDnumerator)) * (int64_t)Mod;
+  if (ErrorNumerator != 0 && Mod != 0) {
+    int64_t ErrorDivisor = (int64_t)MAX2870_outdiv * Sweep.PFDdenominator * Mod;
+    Sweep.FrequencyError = RoundedFrequencyError(ErrorNumerator, ErrorDivisor);
+  }
+
+  int ErrorCode = ValidateFrequency(N_Int, Mod, Frac, Sweep.PFDFrequency);
+  if (ErrorCode != MAX2870_ERROR_NONE) {
+    return ErrorCode;
+  }
+
+  // advance to the next step
+  Sweep.Frequency += Sweep.StepFrequency;
+  Sweep.N_Int += Sweep.N_IntIncrement;
+  Sweep.Remainder += Sweep.RemainderIncrement;
+  if (Sweep.Remainder >= Sweep.PFDnumerator) {
+    Sweep.Remainder -= Sweep.PFDnumerator;
+    Sweep.N_Int++;
+  }
+  if (Sweep.ExactChannels == true) {
+    Sweep.ChannelFrac += Sweep.ChannelFracIncrement;
+    if (Sweep.ChannelFrac >= Sweep.ChannelMod) {
+      Sweep.ChannelFrac -= Sweep.ChannelMod;
+    }
+  }
+  return MAX2870_ERROR_NONE;
+}
+
+template <class Transport>
+bool MAX2870Device<Transport>::CalculateFrequency(uint64_t Frequency, uint16_t FrequencyScale, bool PrecisionFrequency, uint32_t MaximumFrequencyError, uint32_t CalculationTimeout, uint32_t &N_Int, uint32_t &Mod, uint32_t &Frac, uint8_t &RfDivSel) {
+  // all values are kept as exact rationals over the PFD denominator so that no precision is lost:
+  // PFD = PFDnumerator / PFDdenominator, VCO = Frequency * outdiv = VCOnumerator / PFDdenominator (both in units of 1 / FrequencyScale Hz)
+  RfDivSel = SelectOutputDivider(Frequency, FrequencyScale);
+  uint8_t MAX2870_outdiv = (1 << RfDivSel);
+  N_Int = 0;
+  Mod = 2;
+  Frac = 0;
+
+  uint64_t PFDnumerator = MAX2870_reffreq;
+  PFDnumerator *= (1 + ReadRefDoubler());
+  PFDnumerator *= FrequencyScale;
+  uint32_t PFDdenominator = ReadR();
+  PFDdenominator *= (1 + ReadRDIV2());
+  uint64_t VCOnumerator = Frequency * MAX2870_outdiv * PFDdenominator; // maximum of 6 * (10 ^ 12) * 2046
+  uint32_t ErrorDenominator = MAX2870_outdiv * PFDdenominator * FrequencyScale; // converts a VCO remainder over PFDnumerator to Hz at the RF output
+
+  N_Int = VCOnumerator / PFDnumerator; // for 4007.5 MHz RF/10 MHz PFD, result is 400
+  uint64_t Remainder = VCOnumerator % PFDnumerator; // for 4007.5 MHz RF/10 MHz PFD, N remainder is 0.75 of PFDnumerator
+
+  if (PrecisionFrequency == true) { // frequency is 4007.5 MHz, PFD is 10 MHz and output divider is 2
+    uint32_t CalculationTimeStart = millis();
+    // deal with N having remainder greater than (4094 / 4095) and a frequency within ((PFD - (PFD * (1 / 4095)) / output divider)
+    uint64_t RemainderToNextInt = PFDnumerator - Remainder;
+    if (RemainderToNextInt > (PFDnumerator / 4000) || (RemainderToNextInt * 100000000ULL) > (PFDnumerator * 24421ULL)) { // first comparison avoids overflow with a mHz frequency
+      uint32_t PreviousFrequencyError = Remainder / ErrorDenominator; // initial value should the MOD match loop fail to result in FRAC < MOD - integer is 4000 MHz, remainder is 7.5 MHz
+      if (PreviousFrequencyError > MaximumFrequencyError && MAX2870_PrecisionSearch == MAX2870_PRECISION_SEARCH_RATIONAL) { // use fractional division if out of tolerance
+        // a FRAC/MOD is within N Hz at the RF output when |(Remainder * MOD) - (FRAC * PFDnumerator)| < (N * ErrorDenominator * MOD)
+        uint64_t ErrorWindow = ((uint64_t)MaximumFrequencyError + 1) * ErrorDenominator;
+        uint32_t TempFrac;
+        uint32_t TempMod;
+        if (SimplestFraction(Remainder, PFDnumerator, ErrorWindow, TempFrac, TempMod) == false) { // tolerance cannot be obtained with MOD <= 4095
+          // use the smallest MOD which gives the same whole Hz error as the closest FRAC/MOD
+          ClosestFraction(Remainder, PFDnumerator, TempFrac, TempMod);
+          uint64_t RemainderTimesMod = Remainder * TempMod;
+          uint64_t FracTimesPFD = PFDnumerator * TempFrac;
+          uint64_t ErrorNumerator;
+          if (RemainderTimesMod > FracTimesPFD) {
+            ErrorNumerator = RemainderTimesMod - FracTimesPFD;
+          }
+          else {
+            ErrorNumerator = FracTimesPFD - RemainderTimesMod;
+          }
+          ErrorWindow = ((ErrorNumerator / ((uint64_t)ErrorDenominator * TempMod)) + 1) * ErrorDenominator;
+          SimplestFraction(Remainder, PFDnumerator, ErrorWindow, TempFrac, TempMod);
+        }
+        if (TempFrac != 0) { // otherwise the initial INT-only value is already the closest
+          Mod = TempMod;
+          Frac = TempFrac;
+        }
+      }
+      else if (PreviousFrequencyError > MaximumFrequencyError) { // linear reference search
+        for (word ModToMatch = 2; ModToMatch <= 4095; ModToMatch++) {
+          if (CalculationTimeout > 0) {
+            uint32_t CalculationTime = millis();
+            CalculationTime -= CalculationTimeStart;
+            if (CalculationTime > CalculationTimeout) {
+              return false;
+            }
+          }
+          uint64_t RemainderTimesMod = Remainder * ModToMatch;
+          uint32_t TempFrac = ((RemainderTimesMod * 2) + PFDnumerator) / (PFDnumerator * 2); // rounded to the nearest FRAC - result should be 3 for 4007.5 MHz/10 MHz PFD with a MOD of 4
+          if (TempFrac == ModToMatch) { // FRAC must be < MOD
+            TempFrac--;
+          }
+          uint64_t FracTimesPFD = PFDnumerator * TempFrac;
+          uint64_t ErrorNumerator;
+          if (RemainderTimesMod > FracTimesPFD) {
+            ErrorNumerator = RemainderTimesMod - FracTimesPFD;
+          }
+          else {
+            ErrorNumerator = FracTimesPFD - RemainderTimesMod;
+          }
+          uint32_t FrequencyError = ErrorNumerator / ((uint64_t)ErrorDenominator * ModToMatch);
+          if (FrequencyError < PreviousFrequencyError) {
+            PreviousFrequencyError = FrequencyError;
+            Mod = ModToMatch; // result should be 4 for 4007.5 MHz/10 MHz PFD
+            Frac = TempFrac; // result should be 3 to correspond with above line
+          }
+          if (FrequencyError <= MaximumFrequencyError) { // tolerance has been obtained - for 4007.5 MHz, MOD = 4, FRAC = 3; error = 0
+            break;
+          }
+        }
+      }
+    }
+    else {
+      N_Int++;
+    }
+  }
+  else {
+    // for a maximum 105 MHz PFD and a 128 RF divider with frequency steps no smaller than 1 Hz, MOD and FRAC are no larger than 105 * (10 ^ 6) before GCD calculation
+    uint64_t StepDenominator = (uint64_t)MAX2870_ChanStep * PFDdenominator * FrequencyScale;
+    uint32_t GCD_MAX2870_Mod2 = PFDnumerator / StepDenominator;
+    uint32_t GCD_MAX2870_Frac2 = ((Remainder * MAX2870_outdiv * 2) + StepDenominator) / (StepDenominator * MAX2870_outdiv * 2); // rounded to the nearest step
+    ReduceChannelFraction(N_Int, GCD_MAX2870_Mod2, GCD_MAX2870_Frac2);
+    // set the final FRAC/MOD values
+    Frac = GCD_MAX2870_Frac2;
+    Mod = GCD_MAX2870_Mod2;
+  }
+
+  // frequency error at the RF output rounded to the nearest Hz - no issue with divide by 0 regarding MOD (set to 2 by default) and FRAC (set to 0 by default)
+  if (Mod != 0) {
+    int64_t ErrorNumerator = (int64_t)(PFDnumerator * Frac) - ((int64_t)(VCOnumerator - ((uint64_t)N_Int * PFDnumerator)) * (int64_t)Mod);
+    int64_t ErrorDivisor = (int64_t)ErrorDenominator * Mod;
+    MAX2870_FrequencyError = RoundedFrequencyError(ErrorNumerator, ErrorDivisor);
+  }
+  return true;
+}
+
+template <class Transport>
+int MAX2870Device<Transport>::setrf(uint32_t f, uint16_t r, uint8_t ReferenceDivisionType)
+{
+  if (f > 30000000UL && ReferenceDivisionType == MAX2870_REF_DOUBLE) return MAX2870_ERROR_DOUBLER_EXCEEDED;
+  if (r > 1023 || r < 1) return MAX2870_ERROR_R_RANGE;
+  if (f < MAX2870_REFIN_MIN || f > MAX2870_REFIN_MAX) return MAX2870_ERROR_REF_FREQUENCY;
+  if (ReferenceDivisionType != MAX2870_REF_UNDIVIDED && ReferenceDivisionType != MAX2870_REF_HALF && ReferenceDivisionType != MAX2870_REF_DOUBLE) return MAX2870_ERROR_REF_MULTIPLIER_TYPE;
+
+  double ReferenceFactor = 1;
+  if (ReferenceDivisionType == MAX2870_REF_HALF) {
+    ReferenceFactor /= 2;
+  }
+  else if (ReferenceDivisionType == MAX2870_REF_DOUBLE) {
+    ReferenceFactor *= 2;
+  }
+  double newfreq  =  (double) f  * ( (double) ReferenceFactor / (double) r);  // check the loop freq
+
+  if ( newfreq > MAX2870_PFD_MAX || newfreq < MAX2870_PFD_MIN ) return MAX2870_ERROR_PFD_LIMITS;
+
+  MAX2870_reffreq = f ;
+  if (ReferenceDivisionType == MAX2870_REF_DOUBLE) {
+    MAX2870_WriteFields<MAX2870Field_R, MAX2870Field_REFMODE>(MAX2870_R, r, 0b00000010);
+  }
+  else if (ReferenceDivisionType == MAX2870_REF_HALF) {
+    MAX2870_WriteFields<MAX2870Field_R, MAX2870Field_REFMODE>(MAX2870_R, r, 0b00000001);
+  }
+  else {
+    MAX2870_WriteFields<MAX2870Field_R, MAX2870Field_REFMODE>(MAX2870_R, r, 0b00000000);
+  }
+  SetBandSelectDivider(MAX2870_R);
+  SetFastLockDivider(MAX2870_R);
+  return MAX2870_ERROR_NONE;
+}
+
+template <class Transport>
+int MAX2870Device<Transport>::setfDirect(uint16_t R_divider, uint16_t INT_value, uint16_t MOD_value, uint16_t FRAC_value, uint8_t RF_DIVIDER_value, bool FRACTIONAL_MODE) {
+  switch (RF_DIVIDER_value) {
+    case 1:
+      RF_DIVIDER_value = 0;
+      break;
+    case 2:
+      RF_DIVIDER_value = 1;
+      break;
+    case 4:
+      RF_DIVIDER_value = 2;
+      break;
+    case 8:
+      RF_DIVIDER_value = 3;
+      break;
+    case 16:
+      RF_DIVIDER_value = 4;
+      break;
+    case 32:
+      RF_DIVIDER_value = 5;
+      break;
+    case 64:
+      RF_DIVIDER_value = 6;
+      break;
+    case 128:
+      RF_DIVIDER_value = 7;
+      break;
+  }
+  MAX2870Field_R::Write(MAX2870_R, R_divider);
+  SetBandSelectDivider(MAX2870_R);
+  PackFrequency(MAX2870_R, INT_value, MOD_value, FRAC_value, RF_DIVIDER_value, FRACTIONAL_MODE);
+  return WriteRegs();
+}
+
+template <class Transport>
+int MAX2870Device<Transport>::setPowerLevel(uint8_t PowerLevel) {
+  if (PowerLevel > 4) return MAX2870_ERROR_POWER_LEVEL;
+  if (PowerLevel == 0) {
+    MAX2870Field_RFA_EN::Write(MAX2870_R, 0);
+  }
+  else {
+    PowerLevel--;
+    MAX2870_WriteFields<MAX2870Field_RFA_EN, MAX2870Field_APWR>(MAX2870_R, 1, PowerLevel);
+  }
+  return WriteRegs();
+}
+
+template <class Transport>
+int MAX2870Device<Transport>::setAuxPowerLevel(uint8_t PowerLevel) {
+  if (PowerLevel > 4) return MAX2870_ERROR_POWER_LEVEL;
+  if (PowerLevel == 0) {
+    MAX2870Field_RFB_EN::Write(MAX2870_R, 0);
+  }
+  else {
+    PowerLevel--;
+    MAX2870_WriteFields<MAX2870Field_BPWR, MAX2870Field_RFB_EN>(MAX2870_R, PowerLevel, 1);
+  }
+  return WriteRegs();
+}
+
+template <class Transport>
+int MAX2870Device<Transport>::setCPcurrent(float Current) {
+  MAX2870Field_CP::Write(MAX2870_R, CPcurrentBits(Current));
+  return WriteRegs();
+}
+
+template <class Transport>
+uint8_t MAX2870Device<Transport>::CPcurrentBits(float Current) {
+  if (Current < 0.32) {
+    Current = 0.32;
+  }
+  if (Current > 5.12) {
+    Current = 5.12;
+  }
+  Current /= 0.32;
+  Current -= 0.5; // 0 = 0.32 mA per step rounded
+  uint8_t CPcurrent = Current;
+  return CPcurrent;
+}
+
+template <class Transport>
+int MAX2870Device<Transport>::setFastLock(uint8_t Mode, uint32_t Timeout, float BoostCurrent) {
+  if (Mode != MAX2870_FAST_LOCK_OFF && Mode != MAX2870_FAST_LOCK_HARDWARE && Mode != MAX2870_FAST_LOCK_SOFTWARE) {
+    return MAX2870_ERROR_FAST_LOCK_MODE;
+  }
+  if (Mode != MAX2870_FAST_LOCK_OFF && Timeout == 0) {
+    return MAX2870_ERROR_FAST_LOCK_TIMEOUT;
+  }
+  if (Mode == MAX2870_FAST_LOCK_SOFTWARE && MAX2870_WriteMode == MAX2870_WRITE_MODE_QUEUE) { // serviceFastLock() would write outside the queue
+    return MAX2870_ERROR_FAST_LOCK_WRITE_MODE;
+  }
+  if (Mode == MAX2870_FAST_LOCK_HARDWARE && MAX2870_PlaybackRunning == true && MAX2870_PlaybackSteps != NULL) { // tick() would divide in 64 bits for the clock divider of each compact step
+    return MAX2870_ERROR_PLAYBACK_WRITE_MODE;
+  }
+  if (Mode == MAX2870_FAST_LOCK_HARDWARE && (Timeout * ReadPFDfreq()) > (MAX2870_FAST_LOCK_DIVIDER_MAX * 1000000.0 * ReadMod())) { // beyond the clock divider at the current PFD and MOD
+    return MAX2870_ERROR_FAST_LOCK_TIMEOUT;
+  }
+  MAX2870_FastLockTimeout = 0;
+  serviceFastLock(); // a boosted charge pump current is restored before the mode is changed
+  MAX2870_FastLockMode = Mode;
+  MAX2870_FastLockTimeout = Timeout;
+  MAX2870_FastLockBoostCP = CPcurrentBits(BoostCurrent);
+  SetFastLockDivider(MAX2870_R);
+  return WriteRegs();
+}
+
+template <class Transport>
+bool MAX2870Device<Transport>::serviceFastLock() {
+  // restores the charge pump current of MAX2870_FAST_LOCK_SOFTWARE once the timeout has passed with only R2 written
+  if (MAX2870_FastLockPending == false) {
+    return false;
+  }
+  if ((micros() - MAX2870_FastLockStartTime) < MAX2870_FastLockTimeout) {
+    return true;
+  }
+  uint32_t Restored[MAX2870_RegsToWrite];
+  for (int i = 0; i < (int)MAX2870_RegsToWrite; i++) {
+    Restored[i] = MAX2870_R_Written[i];
+  }
+  MAX2870Field_CP::Write(Restored, MAX2870_FastLockRestoreCP);
+  MAX2870_FastLockPending = false;
+  WriteRegisterSet(Restored);
+  return false;
+}
+
+template <class Transport>
+int MAX2870Device<Transport>::setPDpolarity(uint8_t PDpolarity) {
+  if (PDpolarity == MAX2870_LOOP_TYPE_INVERTING || PDpolarity == MAX2870_LOOP_TYPE_NONINVERTING) {
+    MAX2870Field_PDP::Write(MAX2870_R, PDpolarity);
+    return WriteRegs();
+  }
+  else {
+    return MAX2870_ERROR_POLARITY_INVALID;
+  }
+}
+
+template <class Transport>
+int MAX2870Device<Transport>::setPrecisionSearch(uint8_t SearchType) {
+  if (SearchType == MAX2870_PRECISION_SEARCH_RATIONAL || SearchType == MAX2870_PRECISION_SEARCH_LINEAR) {
+    MAX2870_PrecisionSearch = SearchType;
+    return MAX2870_ERROR_NONE;
+  }
+  else {
+    return MAX2870_ERROR_PRECISION_SEARCH_INVALID;
+  }
+}
+
+template <class Transport>
+int MAX2870Device<Transport>::setWriteMode(uint8_t WriteMode) {
+  if (WriteMode == MAX2870_WRITE_MODE_QUEUE && MAX2870_PlaybackRunning == true) return MAX2870_ERROR_PLAYBACK_WRITE_MODE;
+  if (WriteMode == MAX2870_WRITE_MODE_QUEUE && MAX2870_FastLockMode == MAX2870_FAST_LOCK_SOFTWARE) return MAX2870_ERROR_FAST_LOCK_WRITE_MODE;
+  if (WriteMode == MAX2870_WRITE_MODE_QUEUE && MAX2870_VCOCacheMode == MAX2870_VCO_CACHE_LEARN) return MAX2870_ERROR_VCO_CACHE_WRITE_MODE;
+  if (WriteMode == MAX2870_WRITE_MODE_REGISTER || WriteMode == MAX2870_WRITE_MODE_BURST || WriteMode == MAX2870_WRITE_MODE_QUEUE) {
+    MAX2870_WriteMode = WriteMode;
+    return MAX2870_ERROR_NONE;
+  }
+  else {
+    return MAX2870_ERROR_WRITE_MODE_INVALID;
+  }
+}
+
+#endif
@@ -0,0 +1,103 @@
+/*!
+   @file MAX2870Fields.h
+
+   This is part of the Arduino Library for the MAX2870 PLL wideband frequency synthesier
+
+   Register field descriptors - each field is a type with its register index, shift and mask known at compile time
+   so that a read or write is inlined as a single shift and AND/OR on the register
+
+*/
+
+#ifndef MAX2870FIELDS_H
+#define MAX2870FIELDS_H
+#include <stdint.h>
+
+template <uint8_t RegisterIndex, uint8_t FieldShift, uint8_t FieldWidth>
+struct MAX2870Field {
+  static constexpr uint8_t Index = RegisterIndex;
+  static constexpr uint8_t Shift = FieldShift;
+  static constexpr uint32_t Mask = (((1UL << FieldWidth) - 1) << FieldShift);
+
+  // value positioned within the register for combining several fields of the same register
+  static constexpr uint32_t Bits(uint32_t value) {
+    return ((value << Shift) & Mask);
+  }
+  static constexpr uint32_t Get(uint32_t Register) {
+    return ((Register & Mask) >> Shift);
+  }
+  static constexpr uint32_t Set(uint32_t Register, uint32_t value) {
+    return ((Register & ~Mask) | Bits(value));
+  }
+  static inline uint32_t Read(const uint32_t *regs) {
+    return Get(regs[Index]);
+  }
+  static inline void Write(uint32_t *regs, uint32_t value) {
+    regs[Index] = Set(regs[Index], value);
+  }
+};
+
+// two or three fields of the same register with one read-modify-write
+template <class Field1, class Field2>
+inline void MAX2870_WriteFields(uint32_t *regs, uint32_t Value1, uint32_t Value2) {
+  static_assert(Field1::Index == Field2::Index, "fields must be in the same register");
+  regs[Field1::Index] = ((regs[Field1::Index] & ~(Field1::Mask | Field2::Mask)) | Field1::Bits(Value1) | Field2::Bits(Value2));
+}
+
+template <class Field1, class Field2, class Field3>
+inline void MAX2870_WriteFields(uint32_t *regs, uint32_t Value1, uint32_t Value2, uint32_t Value3) {
+  static_assert(Field1::Index == Field2::Index && Field1::Index == Field3::Index, "fields must be in the same register");
+  regs[Field1::Index] = ((regs[Field1::Index] & ~(Field1::Mask | Field2::Mask | Field3::Mask)) | Field1::Bits(Value1) | Field2::Bits(Value2) | Field3::Bits(Value3));
+}
+
+// R0
+typedef MAX2870Field<0x00, 3, 12> MAX2870Field_FRAC;
+typedef MAX2870Field<0x00, 15, 16> MAX2870Field_N; // INT
+typedef MAX2870Field<0x00, 31, 1> MAX2870Field_INT; // integer-n mode
+
+// R1
+typedef MAX2870Field<0x01, 3, 12> MAX2870Field_M; // MOD
+typedef MAX2870Field<0x01, 29, 2> MAX2870Field_CPL; // charge pump linearity
+typedef MAX2870Field<0x01, 31, 1> MAX2870Field_CPOC; // charge pump output clamp
+
+// R2
+typedef MAX2870Field<0x02, 6, 1> MAX2870Field_PDP; // phase detector polarity
+typedef MAX2870Field<0x02, 8, 1> MAX2870Field_LDF; // lock detect function
+typedef MAX2870Field<0x02, 9, 4> MAX2870Field_CP; // charge pump current
+typedef MAX2870Field<0x02, 14, 10> MAX2870Field_R; // R counter
+typedef MAX2870Field<0x02, 24, 1> MAX2870Field_RDIV2; // reference divide by 2
+typedef MAX2870Field<0x02, 25, 1> MAX2870Field_DBR; // reference doubler
+typedef MAX2870Field<0x02, 24, 2> MAX2870Field_REFMODE; // RDIV2 and DBR as MAX2870_REF_(UNDIVIDED/HALF/DOUBLE)
+typedef MAX2870Field<0x02, 26, 3> MAX2870Field_MUX; // MUXOUT (MUX bits 2-0)
+typedef MAX2870Field<0x02, 31, 1> MAX2870Field_LDS; // lock detect speed
+
+// R3
+typedef MAX2870Field<0x03, 3, 12> MAX2870Field_CDIV; // clock divider (fast lock timeout)
+typedef MAX2870Field<0x03, 15, 2> MAX2870Field_CDM; // clock divider mode
+typedef MAX2870Field<0x03, 25, 1> MAX2870Field_VAS_SHDN; // VAS state machine disabled
+typedef MAX2870Field<0x03, 26, 6> MAX2870Field_VCO; // VCO and VCO sub-band manual selection
+
+// R4
+typedef MAX2870Field<0x04, 3, 2> MAX2870Field_APWR; // RF output A power
+typedef MAX2870Field<0x04, 5, 1> MAX2870Field_RFA_EN;
+typedef MAX2870Field<0x04, 6, 2> MAX2870Field_BPWR; // RF output B (auxiliary) power
+typedef MAX2870Field<0x04, 8, 1> MAX2870Field_RFB_EN;
+typedef MAX2870Field<0x04, 9, 1> MAX2870Field_BDIV; // RF output B divided/fundamental
+typedef MAX2870Field<0x04, 12, 8> MAX2870Field_BS; // band select clock divider (bits 7-0)
+typedef MAX2870Field<0x04, 20, 3> MAX2870Field_DIVA; // RF divider select
+typedef MAX2870Field<0x04, 24, 2> MAX2870Field_BS_MSB; // band select clock divider (bits 9-8)
+
+// R5
+typedef MAX2870Field<0x05, 3, 3> MAX2870Field_ADCM; // ADC mode
+typedef MAX2870Field<0x05, 6, 1> MAX2870Field_ADCS; // ADC start
+typedef MAX2870Field<0x05, 18, 1> MAX2870Field_MUX_MSB; // MUXOUT (MUX bit 3)
+typedef MAX2870Field<0x05, 24, 1> MAX2870Field_F01; // integer-n mode when FRAC = 0
+
+// R6 (read only - shifted out on MUXOUT) - Get() only as register arrays hold R0-R5
+typedef MAX2870Field<0x06, 3, 6> MAX2870Field_V; // current VCO band
+typedef MAX2870Field<0x06, 9, 1> MAX2870Field_VASA; // VAS state machine active
+typedef MAX2870Field<0x06, 15, 1> MAX2870Field_ADCV; // ADC data valid
+typedef MAX2870Field<0x06, 16, 7> MAX2870Field_ADC;
+typedef MAX2870Field<0x06, 23, 1> MAX2870Field_POR; // power on reset
+typedef MAX2870Field<0x06, 28, 4> MAX2870Field_DIE; // die revision
+
+#endif
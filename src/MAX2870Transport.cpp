@@ -0,0 +1,183 @@
+/*!
+
+   @file MAX2870Transport.cpp
+
+   This is part of the Arduino Library for the MAX2870 PLL wideband frequency synthesier
+
+   Transports for the MAX2870 registers
+
+*/
+
+#include "MAX2870Transport.h"
+
+void MAX2870HardwareSPI::begin(uint8_t SSpin)
+{
+  MAX2870_PIN_SS = SSpin;
+  pinMode(MAX2870_PIN_SS, OUTPUT);
+  digitalWrite(MAX2870_PIN_SS, HIGH);
+  SPI.begin();
+}
+
+void MAX2870HardwareSPI::write(const uint8_t *Buffer, uint8_t Registers)
+{
+  // all registers are sent within one SPI transaction with LE (SS) latching each register
+  SPI.beginTransaction(MAX2870_SPI);
+  for (int i = 0; i < Registers; i++) {
+    digitalWrite(MAX2870_PIN_SS, LOW);
+    for (int j = 0; j < 4; j++) {
+      SPI.transfer(Buffer[(i * 4) + j]);
+    }
+    digitalWrite(MAX2870_PIN_SS, HIGH);
+  }
+  SPI.endTransaction();
+}
+
+bool MAX2870HardwareSPI::read(uint32_t *Value)
+{
+  uint8_t Buffer[4] = {0x00, 0x00, 0x00, 0x06};
+  SPI.beginTransaction(MAX2870_SPI);
+  digitalWrite(MAX2870_PIN_SS, LOW);
+  SPI.transfer(Buffer, 4); // register 6 starts the readback
+  digitalWrite(MAX2870_PIN_SS, HIGH);
+  Buffer[0] = 0x00;
+  Buffer[1] = 0x00;
+  Buffer[2] = 0x00;
+  Buffer[3] = 0x06;
+  digitalWrite(MAX2870_PIN_SS, LOW);
+  SPI.transfer(Buffer, 4); // register 6 is sent again while R6 is shifted out so that latching it has no effect
+  digitalWrite(MAX2870_PIN_SS, HIGH);
+  SPI.endTransaction();
+  *Value = (((uint32_t)Buffer[0] << 24) | ((uint32_t)Buffer[1] << 16) | ((uint32_t)Buffer[2] << 8) | Buffer[3]);
+  return true;
+}
+
+MAX2870BitBangTransport::MAX2870BitBangTransport(uint8_t ClockPin, uint8_t DataPin, uint8_t MuxPin)
+{
+  MAX2870_PIN_CLOCK = ClockPin;
+  MAX2870_PIN_DATA = DataPin;
+  MAX2870_PIN_MUX = MuxPin;
+}
+
+void MAX2870BitBangTransport::begin(uint8_t SSpin)
+{
+  MAX2870_PIN_SS = SSpin;
+  pinMode(MAX2870_PIN_SS, OUTPUT);
+  digitalWrite(MAX2870_PIN_SS, HIGH);
+  pinMode(MAX2870_PIN_CLOCK, OUTPUT);
+  digitalWrite(MAX2870_PIN_CLOCK, LOW);
+  pinMode(MAX2870_PIN_DATA, OUTPUT);
+  digitalWrite(MAX2870_PIN_DATA, LOW);
+  if (MAX2870_PIN_MUX != MAX2870_PIN_UNUSED) {
+    pinMode(MAX2870_PIN_MUX, INPUT);
+  }
+}
+
+void MAX2870BitBangTransport::write(const uint8_t *Buffer, uint8_t Registers)
+{
+  for (int i = 0; i < Registers; i++) {
+    digitalWrite(MAX2870_PIN_SS, LOW);
+    for (int j = 0; j < 4; j++) {
+      uint8_t value = Buffer[(i * 4) + j];
+      for (int k = 7; k >= 0; k--) { // MSB first with data clocked in on the rising edge
+        digitalWrite(MAX2870_PIN_DATA, ((value >> k) & 1));
+        digitalWrite(MAX2870_PIN_CLOCK, HIGH);
+        digitalWrite(MAX2870_PIN_CLOCK, LOW);
+      }
+    }
+    digitalWrite(MAX2870_PIN_SS, HIGH); // latch the register
+  }
+}
+
+bool MAX2870BitBangTransport::read(uint32_t *Value)
+{
+  if (MAX2870_PIN_MUX == MAX2870_PIN_UNUSED) {
+    return false;
+  }
+  const uint8_t Register6[4] = {0x00, 0x00, 0x00, 0x06};
+  write(Register6, 1); // starts the readback
+  uint32_t Data = 0;
+  digitalWrite(MAX2870_PIN_SS, LOW);
+  for (int k = 31; k >= 0; k--) { // register 6 is clocked in again while R6 is shifted out so that latching it has no effect
+    digitalWrite(MAX2870_PIN_DATA, ((0x00000006UL >> k) & 1));
+    digitalWrite(MAX2870_PIN_CLOCK, HIGH);
+    Data = ((Data << 1) | (digitalRead(MAX2870_PIN_MUX) == HIGH));
+    digitalWrite(MAX2870_PIN_CLOCK, LOW);
+  }
+  digitalWrite(MAX2870_PIN_SS, HIGH);
+  *Value = Data;
+  return true;
+}
+
+MAX2870PortTransport::MAX2870PortTransport(uint8_t ClockPin, uint8_t DataPin, uint8_t MuxPin)
+{
+  MAX2870_PIN_CLOCK = ClockPin;
+  MAX2870_PIN_DATA = DataPin;
+  MAX2870_PIN_MUX = MuxPin;
+}
+
+void MAX2870PortTransport::begin(uint8_t SSpin)
+{
+  pinMode(SSpin, OUTPUT);
+  digitalWrite(SSpin, HIGH);
+  pinMode(MAX2870_PIN_CLOCK, OUTPUT);
+  digitalWrite(MAX2870_PIN_CLOCK, LOW);
+  pinMode(MAX2870_PIN_DATA, OUTPUT);
+  digitalWrite(MAX2870_PIN_DATA, LOW);
+  MAX2870_PORT_SS = portOutputRegister(digitalPinToPort(SSpin));
+  MAX2870_MASK_SS = digitalPinToBitMask(SSpin);
+  MAX2870_PORT_CLOCK = portOutputRegister(digitalPinToPort(MAX2870_PIN_CLOCK));
+  MAX2870_MASK_CLOCK = digitalPinToBitMask(MAX2870_PIN_CLOCK);
+  MAX2870_PORT_DATA = portOutputRegister(digitalPinToPort(MAX2870_PIN_DATA));
+  MAX2870_MASK_DATA = digitalPinToBitMask(MAX2870_PIN_DATA);
+  if (MAX2870_PIN_MUX != MAX2870_PIN_UNUSED) {
+    pinMode(MAX2870_PIN_MUX, INPUT);
+    MAX2870_PORT_MUX = portInputRegister(digitalPinToPort(MAX2870_PIN_MUX));
+    MAX2870_MASK_MUX = digitalPinToBitMask(MAX2870_PIN_MUX);
+  }
+}
+
+void MAX2870PortTransport::write(const uint8_t *Buffer, uint8_t Registers)
+{
+  for (int i = 0; i < Registers; i++) {
+    *MAX2870_PORT_SS &= ~MAX2870_MASK_SS;
+    for (int j = 0; j < 4; j++) {
+      uint8_t value = Buffer[(i * 4) + j];
+      for (int k = 7; k >= 0; k--) { // MSB first with data clocked in on the rising edge
+        if (((value >> k) & 1) != 0) {
+          *MAX2870_PORT_DATA |= MAX2870_MASK_DATA;
+        }
+        else {
+          *MAX2870_PORT_DATA &= ~MAX2870_MASK_DATA;
+        }
+        *MAX2870_PORT_CLOCK |= MAX2870_MASK_CLOCK;
+        *MAX2870_PORT_CLOCK &= ~MAX2870_MASK_CLOCK;
+      }
+    }
+    *MAX2870_PORT_SS |= MAX2870_MASK_SS; // latch the register
+  }
+}
+
+bool MAX2870PortTransport::read(uint32_t *Value)
+{
+  if (MAX2870_PIN_MUX == MAX2870_PIN_UNUSED) {
+    return false;
+  }
+  const uint8_t Register6[4] = {0x00, 0x00, 0x00, 0x06};
+  write(Register6, 1); // starts the readback
+  uint32_t Data = 0;
+  *MAX2870_PORT_SS &= ~MAX2870_MASK_SS;
+  for (int k = 31; k >= 0; k--) { // register 6 is clocked in again while R6 is shifted out so that latching it has no effect
+    if (((0x00000006UL >> k) & 1) != 0) {
+      *MAX2870_PORT_DATA |= MAX2870_MASK_DATA;
+    }
+    else {
+      *MAX2870_PORT_DATA &= ~MAX2870_MASK_DATA;
+    }
+    *MAX2870_PORT_CLOCK |= MAX2870_MASK_CLOCK;
+    Data = ((Data << 1) | ((*MAX2870_PORT_MUX & MAX2870_MASK_MUX) != 0));
+    *MAX2870_PORT_CLOCK &= ~MAX2870_MASK_CLOCK;
+  }
+  *MAX2870_PORT_SS |= MAX2870_MASK_SS;
+  *Value = Data;
+  return true;
+}
@@ -0,0 +1,102 @@
+/*!
+   @file MAX2870Transport.h
+
+   This is part of the Arduino Library for the MAX2870 PLL wideband frequency synthesier
+
+   Register transports for MAX2870Device<Transport> - the hardware SPI (the transport of MAX2870) and two pin transports
+
+*/
+
+#ifndef MAX2870TRANSPORT_H
+#define MAX2870TRANSPORT_H
+#include <Arduino.h>
+#include <SPI.h>
+#include <stdint.h>
+
+#define MAX2870_PIN_UNUSED 0xFF
+
+/*!
+   @brief register transports - the Transport parameter of MAX2870Device
+
+   A transport is a class with these members which are called directly (there is no base class):
+
+   begin(SSpin) is called by init() with the SS (LE) pin.
+
+   write(Buffer, Registers) is called with the registers serialised MSB first (4 bytes per register
+   in the order they are to be written) - LE must be taken high after each register. It is called
+   once for each register under MAX2870_WRITE_MODE_REGISTER and once for all changed registers otherwise.
+
+   read(Value) is called by readStatusRegister() once MUXOUT has been set to register readback -
+   it writes register 6 and shifts R6 in from MUXOUT (MSB first) - transports which cannot
+   read return false.
+*/
+
+// port register and bit mask types of the Arduino core (e.g. volatile uint8_t * and uint8_t on AVR)
+typedef decltype(portOutputRegister(digitalPinToPort(0))) MAX2870PortOutput;
+typedef decltype(portInputRegister(digitalPinToPort(0))) MAX2870PortInput;
+typedef decltype(digitalPinToBitMask(0)) MAX2870PortMask;
+
+/*!
+   @brief the hardware SPI (SPI mode 0, MSB first) with register readback from MUXOUT on MISO
+*/
+class MAX2870HardwareSPI
+{
+  public:
+    void begin(uint8_t SSpin);
+    void write(const uint8_t *Buffer, uint8_t Registers);
+    bool read(uint32_t *Value);
+
+    SPISettings MAX2870_SPI;
+
+  private:
+    uint8_t MAX2870_PIN_SS = 10;
+};
+
+/*!
+   @brief bit-bang transport with digitalWrite() on any two digital pins and SS (SPI mode 0, MSB first) with register readback from MUXOUT on a third pin
+*/
+class MAX2870BitBangTransport
+{
+  public:
+    MAX2870BitBangTransport(uint8_t ClockPin, uint8_t DataPin, uint8_t MuxPin = MAX2870_PIN_UNUSED);
+    void begin(uint8_t SSpin);
+    void write(const uint8_t *Buffer, uint8_t Registers);
+    bool read(uint32_t *Value);
+
+  private:
+    uint8_t MAX2870_PIN_SS = 10;
+    uint8_t MAX2870_PIN_CLOCK;
+    uint8_t MAX2870_PIN_DATA;
+    uint8_t MAX2870_PIN_MUX;
+};
+
+/*!
+   @brief as MAX2870BitBangTransport with the port registers of the pins written directly instead of through digitalWrite()
+
+   Other pins on the same ports must not be changed from an interrupt while the registers are written, as each pin
+   change is a read-modify-write of its port register
+*/
+class MAX2870PortTransport
+{
+  public:
+    MAX2870PortTransport(uint8_t ClockPin, uint8_t DataPin, uint8_t MuxPin = MAX2870_PIN_UNUSED);
+    void begin(uint8_t SSpin);
+    void write(const uint8_t *Buffer, uint8_t Registers);
+    bool read(uint32_t *Value);
+
+  private:
+    uint8_t MAX2870_PIN_CLOCK;
+    uint8_t MAX2870_PIN_DATA;
+    uint8_t MAX2870_PIN_MUX;
+    MAX2870PortOutput MAX2870_PORT_SS;
+    MAX2870PortOutput MAX2870_PORT_CLOCK;
+    MAX2870PortOutput MAX2870_PORT_DATA;
+    MAX2870PortInput MAX2870_PORT_MUX;
+    MAX2870PortMask MAX2870_MASK_SS;
+    MAX2870PortMask MAX2870_MASK_CLOCK;
+    MAX2870PortMask MAX2870_MASK_DATA;
+    MAX2870PortMask MAX2870_MASK_MUX;
+
+};
+
+#endif